@@ -88,6 +88,7 @@ void SelectStartFacilityState::btnOkClick(Action *)
 		delete *i;
 	}
 	_base->getFacilities()->clear();
+	_base->invalidateRadar();
 	_game->popState();
 	_game->popState();
 	_game->pushState(new PlaceLiftState(_game, _base, _globe, true));
@@ -316,7 +316,8 @@ void SellState::btnOkClick(Action *)
 				}
 
 				// Remove items from craft
-				for (std::map<std::string, int>::iterator it = craft->getItems()->getContents()->begin(); it != craft->getItems()->getContents()->end(); ++it)
+				std::map<std::string, int> craftItems = craft->getItems()->getContents();
+				for (std::map<std::string, int>::iterator it = craftItems.begin(); it != craftItems.end(); ++it)
 				{
 					_base->getItems()->addItem(it->first, it->second);
 				}
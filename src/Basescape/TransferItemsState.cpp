@@ -572,7 +572,7 @@ void TransferItemsState::increaseByValue(int change)
 			_game->pushState(new ErrorMessageState(_game, "STR_NO_FREE_ACCOMODATION_CREW", _palette, Palette::blockOffset(15)+1, "BACK13.SCR", 0));
 			return;
 		}
-		if (Options::storageLimitsEnforced && _baseTo->storesOverfull(_iQty + craft->getItems()->getTotalSize(_game->getRuleset())))
+		if (Options::storageLimitsEnforced && _baseTo->storesOverfull(_iQty + craft->getItems()->getTotalSize()))
 		{
 			_timerInc->stop();
 			_game->pushState(new ErrorMessageState(_game, "STR_NOT_ENOUGH_STORE_SPACE_FOR_CRAFT", _palette, Palette::blockOffset(15)+1, "BACK13.SCR", 0));
@@ -610,7 +610,7 @@ void TransferItemsState::increaseByValue(int change)
 		Craft *craft = _crafts[_sel - _soldiers.size()];
 		_cQty++;
 		_pQty += craft->getNumSoldiers();
-		_iQty += craft->getItems()->getTotalSize(_game->getRuleset());
+		_iQty += craft->getItems()->getTotalSize();
 		_baseQty[_sel]--;
 		_transferQty[_sel]++;
 		if (!Options::canTransferCraftsWhileAirborne || craft->getStatus() != "STR_OUT") _total += getCost();
@@ -675,7 +675,7 @@ void TransferItemsState::decreaseByValue(int change)
 		craft = _crafts[_sel - _soldiers.size()];
 		_cQty--;
 		_pQty -= craft->getNumSoldiers();
-		_iQty -= craft->getItems()->getTotalSize(_game->getRuleset());
+		_iQty -= craft->getItems()->getTotalSize();
 	}
 	// Item count
 	else if (TRANSFER_ITEM == selType)
@@ -35,6 +35,7 @@
 #include "../Engine/RNG.h"
 #include "../Engine/Logger.h"
 #include "../Engine/Game.h"
+#include "../Engine/ThreadPool.h"
 #include "../Ruleset/Armor.h"
 #include "../Resource/ResourcePack.h"
 #include "../Ruleset/Ruleset.h"
@@ -43,6 +44,42 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Candidate fire points being checked by the worker threads.
+struct FirePointSearch
+{
+	SavedBattleGame *save;
+	BattleUnit *unit, *target;
+	std::vector<Position> positions;
+	std::vector<char> lineOfFire;
+	size_t first;
+};
+
+/**
+ * Checks if the unit could shoot its target from one of the candidate
+ * positions. Only reads the map, so it's safe to run on several threads.
+ * @param data Pointer to the FirePointSearch.
+ * @param index Candidate to check, counting from the first one of
+ * the current chunk. The result is stored at the candidate's index.
+ */
+void checkFirePoint(void *data, int index)
+{
+	FirePointSearch *search = (FirePointSearch*)data;
+	size_t i = search->first + index;
+	Position pos = search->positions[i];
+	Tile *tile = search->save->getTile(pos);
+	Position target;
+	// i should really make a function for this
+	Position origin = (pos * Position(16,16,24)) +
+		// 4 because -2 is eyes and 2 below that is the rifle (or at least that's my understanding)
+		Position(8,8, search->unit->getHeight() + search->unit->getFloatHeight() - tile->getTerrainLevel() - 4);
+
+	search->lineOfFire[i] = search->save->getTileEngine()->canTargetUnit(&origin, search->target->getTile(), &target, search->unit);
+}
+
+}
 
 /**
  * Sets up a BattleAIState.
@@ -1400,31 +1437,50 @@ bool AlienBAIState::findFirePoint()
 		return false;
 	std::vector<Position> randomTileSearch = _save->getTileSearch();
 	RNG::shuffle(randomTileSearch);
-	Position target;
 	const int BASE_SYSTEMATIC_SUCCESS = 100;
 	const int FAST_PASS_THRESHOLD = 125;
 	int bestScore = 0;
 	_attackAction->type = BA_RETHINK;
+
+	// tracing the lines of fire is the slow part and doesn't change anything,
+	// so check the candidates a chunk at a time, one per processor
+	FirePointSearch search;
+	search.save = _save;
+	search.unit = _unit;
+	search.target = _aggroTarget;
 	for (std::vector<Position>::const_iterator i = randomTileSearch.begin(); i != randomTileSearch.end(); ++i)
 	{
 		Position pos = _unit->getPosition() + *i;
-		Tile *tile = _save->getTile(pos);
-		if (tile == 0  ||
-			std::find(_reachableWithAttack.begin(), _reachableWithAttack.end(), _save->getTileIndex(pos))  == _reachableWithAttack.end())
-			continue;
-		int score = 0;
-		// i should really make a function for this
-		Position origin = (pos * Position(16,16,24)) + 
-			// 4 because -2 is eyes and 2 below that is the rifle (or at least that's my understanding)
-			Position(8,8, _unit->getHeight() + _unit->getFloatHeight() - tile->getTerrainLevel() - 4);
+		if (_save->getTile(pos) != 0 &&
+			std::find(_reachableWithAttack.begin(), _reachableWithAttack.end(), _save->getTileIndex(pos)) != _reachableWithAttack.end())
+		{
+			search.positions.push_back(pos);
+		}
+	}
+	search.lineOfFire.resize(search.positions.size());
+	ThreadPool *pool = _save->getBattleState()->getGame()->getThreadPool();
+	size_t chunk = pool->getThreadCount();
+	if (chunk > 1)
+	{
+		_save->getTileEngine()->bakeVoxelMap();
+	}
 
-		if (_save->getTileEngine()->canTargetUnit(&origin, _aggroTarget->getTile(), &target, _unit))
+	// then score each chunk in the shuffled order, so the choice only depends on the RNG
+	bool found = false;
+	for (search.first = 0; search.first < search.positions.size() && !found; search.first += chunk)
+	{
+		size_t last = std::min(search.first + chunk, search.positions.size());
+		pool->run(checkFirePoint, &search, last - search.first);
+		for (size_t i = search.first; i < last; ++i)
 		{
+			if (!search.lineOfFire[i])
+				continue;
+			Position pos = search.positions[i];
 			_save->getPathfinding()->calculate(_unit, pos);
 			// can move here
 			if (_save->getPathfinding()->getStartDirection() != -1)
 			{
-				score = BASE_SYSTEMATIC_SUCCESS - getSpottingUnits(pos) * 10;
+				int score = BASE_SYSTEMATIC_SUCCESS - getSpottingUnits(pos) * 10;
 				score += _unit->getTimeUnits() - _save->getPathfinding()->getTotalTUCost();
 				if (!_aggroTarget->checkViewSector(pos))
 				{
@@ -1437,6 +1493,7 @@ bool AlienBAIState::findFirePoint()
 					_attackAction->finalFacing = _save->getTileEngine()->getDirectionTo(pos, _aggroTarget->getPosition());
 					if (score > FAST_PASS_THRESHOLD)
 					{
+						found = true;
 						break;
 					}
 				}
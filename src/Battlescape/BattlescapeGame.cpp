@@ -37,6 +37,7 @@
 #include "UnitPanicBState.h"
 #include "AlienBAIState.h"
 #include "CivilianBAIState.h"
+#include "XcomBAIState.h"
 #include "Pathfinding.h"
 #include "../Engine/Game.h"
 #include "../Engine/Language.h"
@@ -69,7 +70,7 @@ bool BattlescapeGame::_debugPlay = false;
  * @param save Pointer to the save game.
  * @param parentState Pointer to the parent battlescape state.
  */
-BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) : _save(save), _parentState(parentState), _playedAggroSound(false), _endTurnRequested(false), _kneelReserved(false)
+BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) : _save(save), _parentState(parentState), _playedAggroSound(false), _endTurnRequested(false), _kneelReserved(false), _playerAI(false)
 {
 	_tuReserved = BA_NONE;
 	_playerTUReserved = BA_NONE;
@@ -102,8 +103,14 @@ void BattlescapeGame::think()
 	// nothing is happening - see if we need some alien AI or units panicking or what have you
 	if (_states.empty())
 	{
-		// it's a non player side (ALIENS or CIVILIANS)
-		if (_save->getSide() != FACTION_PLAYER)
+		// it's a player side && we have not handled all panicking units
+		if (_save->getSide() == FACTION_PLAYER && !_playerPanicHandled)
+		{
+			_playerPanicHandled = handlePanickingPlayer();
+			_save->getBattleState()->updateSoldierInfo();
+		}
+		// it's a non player side (ALIENS or CIVILIANS), or the AI is playing for the player
+		else if (_save->getSide() != FACTION_PLAYER || _playerAI)
 		{
 			if (!_debugPlay)
 			{
@@ -130,15 +137,6 @@ void BattlescapeGame::think()
 				}
 			}
 		}
-		else
-		{
-			// it's a player side && we have not handled all panicking units
-			if (!_playerPanicHandled)
-			{
-				_playerPanicHandled = handlePanickingPlayer();
-				_save->getBattleState()->updateSoldierInfo();
-			}
-		}
 		if (_save->getUnitsFalling())
 		{
 			statePushFront(new UnitFallBState(this));
@@ -202,13 +200,19 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 
 	unit->setVisible(false);
 
-	_save->getTileEngine()->calculateFOV(unit->getPosition()); // might need this populate _visibleUnit for a newly-created alien
+	_save->getTileEngine()->calculateFOV(unit->getPosition(), unit->getArmor()->getSize()); // might need this populate _visibleUnit for a newly-created alien
         // it might also help chryssalids realize they've zombified someone and need to move on
 		// it should also hide units when they've killed the guy spotting them
         // it's also for good luck
 
     BattleAIState *ai = unit->getCurrentAIState();
-	if (!ai)
+	if (unit->getFaction() == FACTION_PLAYER && _playerAI && dynamic_cast<XcomBAIState*>(ai) == 0)
+	{
+		// the player's units, mind controlled aliens included, fight for the player
+		unit->setAIState(new XcomBAIState(_save, unit));
+		ai = unit->getCurrentAIState();
+	}
+	else if (!ai)
 	{
 		// for some reason the unit had no AI routine assigned..
 		if (unit->getFaction() == FACTION_HOSTILE)
@@ -1494,12 +1498,13 @@ void BattlescapeGame::dropItem(const Position &position, BattleItem *item, bool
 		item->setOwner(0);
 	}
 
-	getTileEngine()->applyGravity(_save->getTile(p));
+	Tile *landed = getTileEngine()->applyGravity(_save->getTile(p));
 
 	if (item->getRules()->getBattleType() == BT_FLARE)
 	{
-		getTileEngine()->calculateTerrainLighting();
-		getTileEngine()->calculateFOV(position);
+		// the flare lights up dark tiles, units watching any of them have to look again
+		int reach = getTileEngine()->calculateTerrainLighting(landed);
+		getTileEngine()->calculateFOV(landed->getPosition(), std::max(1, reach));
 	}
 
 }
@@ -1561,7 +1566,7 @@ BattleUnit *BattlescapeGame::convertUnit(BattleUnit *unit, std::string newType)
 	bi->moveToOwner(newUnit);
 	bi->setSlot(getRuleset()->getInventory("STR_RIGHT_HAND"));
 	getSave()->getItems()->push_back(bi);
-	getTileEngine()->calculateFOV(newUnit->getPosition());
+	getTileEngine()->calculateFOV(newUnit->getPosition(), newUnit->getArmor()->getSize());
 	getTileEngine()->applyGravity(newUnit->getTile());
 	//newUnit->getCurrentAIState()->think();
 	return newUnit;
@@ -2050,4 +2055,14 @@ bool BattlescapeGame::checkForProximityGrenades(BattleUnit *unit)
 	return false;
 }
 
+/**
+ * Sets whether the player's units are played by the AI as well,
+ * so a battle can run its course with nobody at the controls.
+ * @param playerAI True to let the AI play the player's side.
+ */
+void BattlescapeGame::setPlayerAI(bool playerAI)
+{
+	_playerAI = playerAI;
+}
+
 }
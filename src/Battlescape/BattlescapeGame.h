@@ -90,7 +90,7 @@ private:
 	std::vector<InfoboxOKState*> _infoboxQueue;
 	/// Shows the infoboxes in the queue (if any).
 	void showInfoBoxQueue();
-	bool _playedAggroSound, _endTurnRequested, _kneelReserved;
+	bool _playedAggroSound, _endTurnRequested, _kneelReserved, _playerAI;
 public:
 	/// Creates the BattlescapeGame state.
 	BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState);
@@ -187,6 +187,8 @@ public:
 	bool getKneelReserved();
 	/// Checks for and triggers proximity grenades.
 	bool checkForProximityGrenades(BattleUnit *unit);
+	/// Sets whether the player's units are played by the AI.
+	void setPlayerAI(bool playerAI);
 };
 
 }
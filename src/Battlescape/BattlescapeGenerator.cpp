@@ -412,7 +412,8 @@ void BattlescapeGenerator::deployXCOM()
 	if (_craft != 0)
 	{
 		// add items that are in the craft
-		for (std::map<std::string, int>::iterator i = _craft->getItems()->getContents()->begin(); i != _craft->getItems()->getContents()->end(); ++i)
+		std::map<std::string, int> craftItems = _craft->getItems()->getContents();
+		for (std::map<std::string, int>::iterator i = craftItems.begin(); i != craftItems.end(); ++i)
 		{
 			for (int count = 0; count < i->second; count++)
 			{
@@ -423,7 +424,8 @@ void BattlescapeGenerator::deployXCOM()
 	else
 	{
 		// add items that are in the base
-		for (std::map<std::string, int>::iterator i = _base->getItems()->getContents()->begin(); i != _base->getItems()->getContents()->end();)
+		std::map<std::string, int> baseItems = _base->getItems()->getContents();
+		for (std::map<std::string, int>::iterator i = baseItems.begin(); i != baseItems.end(); ++i)
 		{
 			// only put items in the battlescape that make sense (when the item got a sprite, it's probably ok)
 			RuleItem *rule = _game->getRuleset()->getItem(i->first);
@@ -431,15 +433,9 @@ void BattlescapeGenerator::deployXCOM()
 			{
 				for (int count = 0; count < i->second; count++)
 				{
-					_craftInventoryTile->addItem(new BattleItem(_game->getRuleset()->getItem(i->first), _save->getCurrentItemId()), ground);
+					_craftInventoryTile->addItem(new BattleItem(rule, _save->getCurrentItemId()), ground);
 				}
-				std::map<std::string, int>::iterator tmp = i;
-				++i;
-				_base->getItems()->removeItem(tmp->first, tmp->second);
-			}
-			else
-			{
-				++i;
+				_base->getItems()->removeItem(rule, i->second);
 			}
 		}
 		// add items from crafts in base
@@ -447,7 +443,8 @@ void BattlescapeGenerator::deployXCOM()
 		{
 			if ((*c)->getStatus() == "STR_OUT")
 				continue;
-			for (std::map<std::string, int>::iterator i = (*c)->getItems()->getContents()->begin(); i != (*c)->getItems()->getContents()->end(); ++i)
+			std::map<std::string, int> craftItems = (*c)->getItems()->getContents();
+			for (std::map<std::string, int>::iterator i = craftItems.begin(); i != craftItems.end(); ++i)
 			{
 				for (int count = 0; count < i->second; count++)
 				{
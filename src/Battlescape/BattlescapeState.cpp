@@ -60,6 +60,7 @@
 #include "../Interface/NumberText.h"
 #include "../Savegame/SavedGame.h"
 #include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/SaveWriter.h"
 #include "../Savegame/Tile.h"
 #include "../Savegame/BattleUnit.h"
 #include "../Savegame/Soldier.h"
@@ -83,6 +84,7 @@
 #include "../Engine/CrossPlatform.h"
 #include "../Menu/LoadGameState.h"
 #include "../Menu/SaveGameState.h"
+#include "../Menu/ErrorMessageState.h"
 
 namespace OpenXcom
 {
@@ -165,6 +167,7 @@ BattlescapeState::BattlescapeState(Game *game) : State(game), _popups(), _xBefor
 	_barMorale = new Bar(102, 3, _icons->getX() + 170, _icons->getY() + 53);
 
 	_txtDebug = new Text(300, 10, 20, 0);
+	_txtSaving = new Text(300, 10, 20, 10);
 	_txtTooltip = new Text(300, 10, _icons->getX() + 2, _icons->getY() - 10);
 
 	// Set palette
@@ -219,6 +222,7 @@ BattlescapeState::BattlescapeState(Game *game) : State(game), _popups(), _xBefor
 	}
 	add(_warning);
 	add(_txtDebug);
+	add(_txtSaving);
 	add(_txtTooltip);
 	add(_btnLaunch);
 	_game->getResourcePack()->getSurfaceSet("SPICONS.DAT")->getFrame(0)->blit(_btnLaunch);
@@ -446,6 +450,11 @@ BattlescapeState::BattlescapeState(Game *game) : State(game), _popups(), _xBefor
 	_txtDebug->setColor(Palette::blockOffset(8));
 	_txtDebug->setHighContrast(true);
 
+	_txtSaving->setColor(Palette::blockOffset(8));
+	_txtSaving->setHighContrast(true);
+	_txtSaving->setText(tr("STR_SAVING_GAME"));
+	_txtSaving->setVisible(false);
+
 	_txtTooltip->setColor(Palette::blockOffset(0)-1);
 	_txtTooltip->setHighContrast(true);
 
@@ -551,6 +560,16 @@ void BattlescapeState::think()
 {
 	static bool popped = false;
 
+	// Show background saves in progress and report the ones that couldn't be written
+	_txtSaving->setVisible(_game->getSaveWriter()->isBusy());
+	std::string error;
+	if (_game->getSaveWriter()->getError(&error))
+	{
+		std::wostringstream msg;
+		msg << tr("STR_SAVE_UNSUCCESSFUL") << L'\x02' << Language::fsToWstr(error);
+		popup(new ErrorMessageState(_game, msg.str(), _palette, Palette::blockOffset(0), "TAC00.SCR", -1));
+	}
+
 	if (_gameTimer->isRunning())
 	{
 		if (_popups.empty())
@@ -2079,12 +2098,12 @@ void BattlescapeState::resize(int &dX, int &dY)
 
 	for (std::vector<Surface*>::const_iterator i = _surfaces.begin(); i != _surfaces.end(); ++i)
 	{
-		if (*i != _map && (*i) != _btnPsi && *i != _btnLaunch && *i != _txtDebug)
+		if (*i != _map && (*i) != _btnPsi && *i != _btnLaunch && *i != _txtDebug && *i != _txtSaving)
 		{
 			(*i)->setX((*i)->getX() + dX / 2);
 			(*i)->setY((*i)->getY() + dY);
 		}
-		else if (*i != _map && *i != _txtDebug)
+		else if (*i != _map && *i != _txtDebug && *i != _txtSaving)
 		{
 			(*i)->setX((*i)->getX() + dX);
 		}
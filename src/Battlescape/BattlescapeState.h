@@ -67,7 +67,7 @@ private:
 	Bar *_barTimeUnits, *_barEnergy, *_barHealth, *_barMorale;
 	Timer *_animTimer, *_gameTimer;
 	SavedBattleGame *_save;
-	Text *_txtDebug, *_txtTooltip;
+	Text *_txtDebug, *_txtTooltip, *_txtSaving;
 	std::vector<State*> _popups;
 	BattlescapeGame *_battleGame;
 	bool _firstInit;
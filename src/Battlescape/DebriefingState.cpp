@@ -977,7 +977,7 @@ void DebriefingState::prepareDebriefing()
  */
 void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCanBeDestroyed)
 {
-	std::map<std::string, int> craftItems = *craft->getItems()->getContents();
+	std::map<std::string, int> craftItems = craft->getItems()->getContents();
 	for (std::map<std::string, int>::iterator i = craftItems.begin(); i != craftItems.end(); ++i)
 	{
 		int qty = base->getItems()->getItem(i->first);
@@ -996,7 +996,7 @@ void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCa
 	}
 
 	// Now let's see the vehicles
-	ItemContainer craftVehicles;
+	ItemContainer craftVehicles(_game->getRuleset());
 	for (std::vector<Vehicle*>::iterator i = craft->getVehicles()->begin(); i != craft->getVehicles()->end(); ++i)
 		craftVehicles.addItem((*i)->getRules()->getType());
 	// Now we know how many vehicles (separated by types) we have to read
@@ -1006,7 +1006,8 @@ void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCa
 			delete (*i);
 	craft->getVehicles()->clear();
 	// Ok, now read those vehicles
-	for (std::map<std::string, int>::iterator i = craftVehicles.getContents()->begin(); i != craftVehicles.getContents()->end(); ++i)
+	std::map<std::string, int> vehicles = craftVehicles.getContents();
+	for (std::map<std::string, int>::iterator i = vehicles.begin(); i != vehicles.end(); ++i)
 	{
 		int qty = base->getItems()->getItem(i->first);
 		RuleItem *tankRule = _game->getRuleset()->getItem(i->first);
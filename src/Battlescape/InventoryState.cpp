@@ -375,8 +375,10 @@ void InventoryState::btnOkClick(Action *)
 	}
 	if (_battleGame->getTileEngine())
 	{
-		_battleGame->getTileEngine()->applyGravity(inventoryTile);
-		_battleGame->getTileEngine()->calculateTerrainLighting(); // dropping/picking up flares
+		Tile *landed = _battleGame->getTileEngine()->applyGravity(inventoryTile);
+		// dropping/picking up flares
+		_battleGame->getTileEngine()->calculateTerrainLighting(inventoryTile);
+		_battleGame->getTileEngine()->calculateTerrainLighting(landed);
 		_battleGame->getTileEngine()->recalculateFOV();
 	}
 }
@@ -19,6 +19,7 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <fstream>
+#include <algorithm>
 #include "Map.h"
 #include "Camera.h"
 #include "UnitSprite.h"
@@ -41,6 +42,7 @@
 #include "../Savegame/Tile.h"
 #include "../Savegame/BattleUnit.h"
 #include "../Savegame/BattleItem.h"
+#include "../Ruleset/Ruleset.h"
 #include "../Ruleset/RuleItem.h"
 #include "../Ruleset/MapDataSet.h"
 #include "../Ruleset/MapData.h"
@@ -68,6 +70,23 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/**
+ * Divides rounding towards negative infinity,
+ * for the screen bounds of tiles left or above the view.
+ * @param a Dividend.
+ * @param b Divisor, must be positive.
+ * @return Rounded quotient.
+ */
+inline int floorDiv(int a, int b)
+{
+	return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+}
+
 /**
  * Sets up a map with the specified size and position.
  * @param game Pointer to the core game.
@@ -89,6 +108,18 @@ Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight)
 	_res = _game->getResourcePack();
 	_spriteWidth = _res->getSurfaceSet("BLANKS.PCK")->getFrame(0)->getWidth();
 	_spriteHeight = _res->getSurfaceSet("BLANKS.PCK")->getFrame(0)->getHeight();
+	// look these up once rather than for every tile drawn
+	_cursorSet = _res->getSurfaceSet("CURSOR.PCK");
+	_smokeSet = _res->getSurfaceSet("SMOKE.PCK");
+	_floorObSet = _res->getSurfaceSet("FLOOROB.PCK");
+	_projectileSet = _res->getSurfaceSet("Projectiles");
+	_pathfindingSet = _res->getSurfaceSet("Pathfinding");
+	_explosionSet = _res->getSurfaceSet("X1.PCK");
+	_hitSet = _res->getSurfaceSet("HIT.PCK");
+	_handObSet = _res->getSurfaceSet("HANDOB.PCK");
+	_handOb2Set = _res->getSurfaceSet("HANDOB2.PCK");
+	_rightHand = _game->getRuleset()->getInventory("STR_RIGHT_HAND");
+	_leftHand = _game->getRuleset()->getInventory("STR_LEFT_HAND");
 	_save = _game->getSavedGame()->getSavedBattle();
 	_message = new BattlescapeMessage(320, (visibleMapHeight < 200)? visibleMapHeight : 200, 0, 0);
 	_message->setX(_game->getScreen()->getDX());
@@ -369,12 +400,29 @@ void Map::drawTerrain(Surface *surface)
 		_numWaypid->setColor(Palette::blockOffset(pathfinderTurnedOn ? 0 : 1));
 	}
 
+	// a cell's screen position moves by a fixed step along each axis, so
+	// the cells that pass the on-screen check below form a band of y in
+	// every row of x; work those out instead of trying the whole map
+	const Position offset = _camera->getMapOffset();
+	const int halfWidth = _spriteWidth / 2, quarterWidth = _spriteWidth / 4;
+	const int levelHeight = (_spriteHeight + _spriteWidth / 4) / 2;
+	const int left = -_spriteWidth - offset.x, right = surface->getWidth() + _spriteWidth - offset.x;
+	const int top = -_spriteHeight - offset.y, bottom = surface->getHeight() + _spriteHeight - offset.y;
+
 	surface->lock();
 	for (int itZ = beginZ; itZ <= endZ; itZ++)
 	{
 		for (int itX = beginX; itX <= endX; itX++)
 		{
-			for (int itY = beginY; itY <= endY; itY++)
+			// (x - y) * halfWidth must lie strictly inside left..right
+			int rowBeginY = floorDiv(itX * halfWidth - right, halfWidth) + 1;
+			int rowEndY = floorDiv(itX * halfWidth - left - 1, halfWidth);
+			// (x + y) * quarterWidth - z * levelHeight strictly inside top..bottom
+			rowBeginY = std::max(rowBeginY, floorDiv(top + itZ * levelHeight - itX * quarterWidth, quarterWidth) + 1);
+			rowEndY = std::min(rowEndY, floorDiv(bottom + itZ * levelHeight - itX * quarterWidth - 1, quarterWidth));
+			rowBeginY = std::max(rowBeginY, beginY);
+			rowEndY = std::min(rowEndY, endY);
+			for (int itY = rowBeginY; itY <= rowEndY; itY++)
 			{
 				mapPosition = Position(itX, itY, itZ);
 				_camera->convertMapToScreen(mapPosition, &screenPosition);
@@ -424,13 +472,13 @@ void Map::drawTerrain(Surface *surface)
 								else
 									frameNumber = 6; // red static crosshairs
 							}
-							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
+							tmpSurface = _cursorSet->getFrame(frameNumber);
 							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
 						}
 						else if (_camera->getViewLevel() > itZ)
 						{
 							frameNumber = 2; // blue box
-							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
+							tmpSurface = _cursorSet->getFrame(frameNumber);
 							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
 						}
 					}
@@ -472,7 +520,7 @@ void Map::drawTerrain(Surface *surface)
 								if (bu->getFire() > 0)
 								{
 									frameNumber = 4 + (_animFrame / 2);
-									tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
+									tmpSurface = _smokeSet->getFrame(frameNumber);
 									tmpSurface->blitNShade(surface, screenPosition.x + offset.x + tileOffset.x, screenPosition.y + offset.y + tileOffset.y, 0);
 								}
 							}
@@ -604,7 +652,7 @@ void Map::drawTerrain(Surface *surface)
 								int sprite = tileWest->getTopItemSprite();
 								if (sprite != -1)
 								{
-									tmpSurface = _res->getSurfaceSet("FLOOROB.PCK")->getFrame(sprite);
+									tmpSurface = _floorObSet->getFrame(sprite);
 									tmpSurface->blitNShade(surface, screenPosition.x - tileOffset.x, screenPosition.y + tileWest->getTerrainLevel() + tileOffset.y, tileWestShade);
 								}
 								// Draw soldier
@@ -621,7 +669,7 @@ void Map::drawTerrain(Surface *surface)
 										if (westUnit->getFire() > 0)
 										{
 											frameNumber = 4 + (_animFrame / 2);
-											tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
+											tmpSurface = _smokeSet->getFrame(frameNumber);
 											tmpSurface->blitNShade(surface, screenPosition.x - tileOffset.x, screenPosition.y + tileOffset.y + getTerrainLevel(westUnit->getPosition(), westUnit->getArmor()->getSize()), 0);
 										}
 									}
@@ -644,7 +692,7 @@ void Map::drawTerrain(Surface *surface)
 									{
 										frameNumber += (_animFrame / 2) + tileWest->getAnimationOffset();
 									}
-									tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
+									tmpSurface = _smokeSet->getFrame(frameNumber);
 									tmpSurface->blitNShade(surface, screenPosition.x - tileOffset.x, screenPosition.y + tileOffset.y, 0);
 								}
 							}
@@ -695,7 +743,7 @@ void Map::drawTerrain(Surface *surface)
 						int sprite = tile->getTopItemSprite();
 						if (sprite != -1)
 						{
-							tmpSurface = _res->getSurfaceSet("FLOOROB.PCK")->getFrame(sprite);
+							tmpSurface = _floorObSet->getFrame(sprite);
 							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y + tile->getTerrainLevel(), tileShade, false);
 						}
 
@@ -744,7 +792,7 @@ void Map::drawTerrain(Surface *surface)
 							{
 								for (int i = 0; i < BULLET_SPRITES; ++i)
 								{
-									tmpSurface = _res->getSurfaceSet("Projectiles")->getFrame(_projectile->getParticle(i));
+									tmpSurface = _projectileSet->getFrame(_projectile->getParticle(i));
 									if (tmpSurface)
 									{
 										Position voxelPos = _projectile->getPosition(1-i);
@@ -795,7 +843,7 @@ void Map::drawTerrain(Surface *surface)
 							if (unit->getFire() > 0)
 							{
 								frameNumber = 4 + (_animFrame / 2);
-								tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
+								tmpSurface = _smokeSet->getFrame(frameNumber);
 								tmpSurface->blitNShade(surface, screenPosition.x + offset.x, screenPosition.y + offset.y, 0);
 							}
 						}
@@ -826,7 +874,7 @@ void Map::drawTerrain(Surface *surface)
 								if (tunit->getFire() > 0)
 								{
 									frameNumber = 4 + (_animFrame / 2);
-									tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
+									tmpSurface = _smokeSet->getFrame(frameNumber);
 									tmpSurface->blitNShade(surface, screenPosition.x + offset.x, screenPosition.y + offset.y, 0);
 								}
 							}
@@ -850,7 +898,7 @@ void Map::drawTerrain(Surface *surface)
 						{
 							frameNumber += (_animFrame / 2) + tile->getAnimationOffset();
 						}
-						tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
+						tmpSurface = _smokeSet->getFrame(frameNumber);
 						tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
 					}
 
@@ -859,13 +907,13 @@ void Map::drawTerrain(Surface *surface)
 					{
 						if (itZ > 0 && tile->hasNoFloor(tileBelow))
 						{
-							tmpSurface = _res->getSurfaceSet("Pathfinding")->getFrame(11);
+							tmpSurface = _pathfindingSet->getFrame(11);
 							if (tmpSurface)
 							{
 								tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y+2, 0, false, tile->getMarkerColor());
 							}
 						}
-						tmpSurface = _res->getSurfaceSet("Pathfinding")->getFrame(tile->getPreview());
+						tmpSurface = _pathfindingSet->getFrame(tile->getPreview());
 						if (tmpSurface)
 						{
 							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y + tile->getTerrainLevel(), 0, false, tileColor);
@@ -900,7 +948,7 @@ void Map::drawTerrain(Surface *surface)
 								else
 									frameNumber = 6; // red static crosshairs
 							}
-							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
+							tmpSurface = _cursorSet->getFrame(frameNumber);
 							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
 
 							// UFO extender accuracy: display adjusted accuracy value on crosshair in real-time.
@@ -960,13 +1008,13 @@ void Map::drawTerrain(Surface *surface)
 						else if (_camera->getViewLevel() > itZ)
 						{
 							frameNumber = 5; // blue box
-							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
+							tmpSurface = _cursorSet->getFrame(frameNumber);
 							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
 						}
 						if (_cursorType > 2 && _camera->getViewLevel() == itZ)
 						{
 							int frame[6] = {0, 0, 0, 11, 13, 15};
-							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frame[_cursorType] + (_animFrame / 4));
+							tmpSurface = _cursorSet->getFrame(frame[_cursorType] + (_animFrame / 4));
 							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
 						}
 					}
@@ -982,7 +1030,7 @@ void Map::drawTerrain(Surface *surface)
 						{
 							if (waypXOff == 2 && waypYOff == 2)
 							{
-								tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(7);
+								tmpSurface = _cursorSet->getFrame(7);
 								tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
 							}
 							if (_save->getBattleGame()->getCurrentAction()->type == BA_LAUNCH)
@@ -1030,14 +1078,14 @@ void Map::drawTerrain(Surface *surface)
 						{
 							if (itZ > 0 && tile->hasNoFloor(tileBelow))
 							{
-								tmpSurface = _res->getSurfaceSet("Pathfinding")->getFrame(23);
+								tmpSurface = _pathfindingSet->getFrame(23);
 								if (tmpSurface)
 								{
 									tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y+2, 0, false, tile->getMarkerColor());
 								}
 							}
 							int overlay = tile->getPreview() + 12;
-							tmpSurface = _res->getSurfaceSet("Pathfinding")->getFrame(overlay);
+							tmpSurface = _pathfindingSet->getFrame(overlay);
 							if (tmpSurface)
 							{
 								tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - adjustment, 0, false, tile->getMarkerColor());
@@ -1086,18 +1134,18 @@ void Map::drawTerrain(Surface *surface)
 			{
 				if ((*i)->getCurrentFrame() >= 0)
 				{
-					tmpSurface = _res->getSurfaceSet("X1.PCK")->getFrame((*i)->getCurrentFrame());
+					tmpSurface = _explosionSet->getFrame((*i)->getCurrentFrame());
 					tmpSurface->blitNShade(surface, bulletPositionScreen.x - 64, bulletPositionScreen.y - 64, 0);
 				}
 			}
 			else if ((*i)->isHit())
 			{
-				tmpSurface = _res->getSurfaceSet("HIT.PCK")->getFrame((*i)->getCurrentFrame());
+				tmpSurface = _hitSet->getFrame((*i)->getCurrentFrame());
 				tmpSurface->blitNShade(surface, bulletPositionScreen.x - 15, bulletPositionScreen.y - 25, 0);
 			}
 			else
 			{
-				tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame((*i)->getCurrentFrame());
+				tmpSurface = _smokeSet->getFrame((*i)->getCurrentFrame());
 				tmpSurface->blitNShade(surface, bulletPositionScreen.x - 15, bulletPositionScreen.y - 15, 0);
 			}
 		}
@@ -1393,6 +1441,9 @@ void Map::cacheUnit(BattleUnit *unit)
 	unit->getCache(&invalid);
 	if (invalid)
 	{
+		SurfaceSet *unitSet = _res->getSurfaceSet(unit->getArmor()->getSpriteSheet());
+		BattleItem *rhandItem = unit->getItem(_rightHand);
+		BattleItem *lhandItem = unit->getItem(_leftHand);
 		// 1 or 4 iterations, depending on unit size
 		for (int i = 0; i < numOfParts; i++)
 		{
@@ -1404,8 +1455,6 @@ void Map::cacheUnit(BattleUnit *unit)
 			}
 			unitSprite->setBattleUnit(unit, i);
 
-			BattleItem *rhandItem = unit->getItem("STR_RIGHT_HAND");
-			BattleItem *lhandItem = unit->getItem("STR_LEFT_HAND");
 			if (rhandItem)
 			{
 				unitSprite->setBattleItem(rhandItem);
@@ -1419,9 +1468,7 @@ void Map::cacheUnit(BattleUnit *unit)
 			{
 				unitSprite->setBattleItem(0);
 			}
-			unitSprite->setSurfaces(_res->getSurfaceSet(unit->getArmor()->getSpriteSheet()),
-									_res->getSurfaceSet("HANDOB.PCK"),
-									_res->getSurfaceSet("HANDOB2.PCK"));
+			unitSprite->setSurfaces(unitSet, _handObSet, _handOb2Set);
 			unitSprite->setAnimationFrame(_animFrame);
 			cache->clear();
 			unitSprite->blit(cache);
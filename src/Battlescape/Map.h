@@ -38,6 +38,8 @@ class BattlescapeMessage;
 class Camera;
 class Timer;
 class Text;
+class SurfaceSet;
+class RuleInventory;
 
 enum CursorType { CT_NONE, CT_NORMAL, CT_AIM, CT_PSI, CT_WAYPOINT, CT_THROW };
 /**
@@ -70,6 +72,8 @@ private:
 	bool _unitDying, _smoothCamera, _smoothingEngaged;
 	PathPreview _previewSetting;
 	Text *_txtAccuracy;
+	SurfaceSet *_cursorSet, *_smokeSet, *_floorObSet, *_projectileSet, *_pathfindingSet, *_explosionSet, *_hitSet, *_handObSet, *_handOb2Set;
+	RuleInventory *_rightHand, *_leftHand;
 
 	void drawTerrain(Surface *surface);
 	int getTerrainLevel(Position pos, int size);
@@ -39,9 +39,12 @@ namespace OpenXcom
  * Sets up a Pathfinding.
  * @param save pointer to SavedBattleGame object.
  */
-Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _nodes(), _unit(0), _pathPreviewed(false), _strafeMove(false), _totalTUCost(0), _modifierUsed(false), _movementType(MT_WALK)
+Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _nodes(), _unit(0), _pathPreviewed(false), _strafeMove(false), _totalTUCost(0), _modifierUsed(false), _movementType(MT_WALK), _wallBlockageGeneration(-1)
 {
+	_reachable.unit = 0;
 	_size = _save->getMapSizeXYZ();
+	_wallBlockage.resize(_size * MOVEMENT_TYPES, 0);
+	_terrainVersions.resize(_size, -1);
 	// Initialize one node per tile
 	_nodes.reserve(_size);
 	Position p;
@@ -664,6 +667,9 @@ bool Pathfinding::isBlocked(Tile *tile, const int part, BattleUnit *missileTarge
 
 /**
  * Determines whether going from one tile to another blocks movement.
+ * Only walls are involved, so unless we're guiding a missile through doors
+ * the answer for all 8 directions is worked out once per tile and movement type,
+ * and kept until the terrain around the tile changes.
  * @param startTile The tile to start from.
  * @param endTile The tile we want to reach.
  * @param direction The direction we are facing.
@@ -671,6 +677,68 @@ bool Pathfinding::isBlocked(Tile *tile, const int part, BattleUnit *missileTarge
  * @return True if the movement is blocked.
  */
 bool Pathfinding::isBlocked(Tile *startTile, Tile * /* endTile */, const int direction, BattleUnit *missileTarget)
+{
+	if (missileTarget != 0 || direction < 0 || direction >= DIR_UP)
+	{
+		return isBlockedByWalls(startTile, direction, missileTarget);
+	}
+
+	updateWallBlockage();
+	Uint16 &blockage = _wallBlockage[_save->getTileIndex(startTile->getPosition()) * MOVEMENT_TYPES + _movementType];
+	if (!(blockage & WALLS_KNOWN))
+	{
+		blockage = WALLS_KNOWN;
+		for (int dir = 0; dir < DIR_UP; ++dir)
+		{
+			if (isBlockedByWalls(startTile, dir, 0))
+			{
+				blockage |= 1 << dir;
+			}
+		}
+	}
+	return (blockage & (1 << direction)) != 0;
+}
+
+/**
+ * Checks the terrain around every tile that changed since the last check,
+ * and forgets the wall blockage of the tiles next to it, as well as its own.
+ */
+void Pathfinding::updateWallBlockage()
+{
+	if (_wallBlockageGeneration == Tile::getMapGeneration())
+		return;
+
+	for (int i = 0; i < _size; ++i)
+	{
+		Tile *tile = _save->getTiles()[i];
+		if (_terrainVersions[i] != tile->getTerrainVersion())
+		{
+			_terrainVersions[i] = tile->getTerrainVersion();
+			for (int x = -1; x <= 1; ++x)
+			{
+				for (int y = -1; y <= 1; ++y)
+				{
+					Tile *neighbour = _save->getTile(tile->getPosition() + Position(x, y, 0));
+					if (neighbour)
+					{
+						int index = _save->getTileIndex(neighbour->getPosition()) * MOVEMENT_TYPES;
+						std::fill(_wallBlockage.begin() + index, _wallBlockage.begin() + index + MOVEMENT_TYPES, 0);
+					}
+				}
+			}
+		}
+	}
+	_wallBlockageGeneration = Tile::getMapGeneration();
+}
+
+/**
+ * Determines whether walls or big walls block going from one tile to the next.
+ * @param startTile The tile to start from.
+ * @param direction The direction we are facing.
+ * @param missileTarget Target for a missile.
+ * @return True if the movement is blocked.
+ */
+bool Pathfinding::isBlockedByWalls(Tile *startTile, const int direction, BattleUnit *missileTarget)
 {
 
 	// check if the difference in height between start and destination is not too high
@@ -1078,7 +1146,11 @@ bool Pathfinding::bresenhamPath(const Position& origin, const Position& target,
 
 /**
  * Locates all tiles reachable to @a *unit with a TU cost no more than @a tuMax.
- * Uses Dijkstra's algorithm.
+ * Uses Dijkstra's algorithm. The AI asks this several times for the same unit
+ * while it thinks, so the last result is kept and reused as long as the unit
+ * hasn't moved, no tile on the map has changed and no unit has been
+ * spotted or lost from sight. A smaller TU budget
+ * is answered from the cached result of a larger one.
  * @param unit Pointer to the unit.
  * @param tuMax The maximum cost of the path to each tile.
  * @return An array of reachable tiles, sorted in ascending order of cost. The first tile is the start location.
@@ -1087,6 +1159,28 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 {
 	const Position &start = unit->getPosition();
 	int energyMax = unit->getEnergy();
+	std::vector<int> tiles;
+
+	// strafing costs depend on the unit's facing, don't bother caching those.
+	bool cacheable = !_strafeMove;
+	if (cacheable
+		&& _reachable.unit == unit
+		&& _reachable.start == start
+		&& _reachable.faction == unit->getFaction()
+		&& _reachable.movementType == _movementType
+		&& _reachable.energyMax == energyMax
+		&& _reachable.mapGeneration == Tile::getMapGeneration()
+		&& _reachable.spottingGeneration == BattleUnit::getSpottingGeneration()
+		&& _reachable.tuMax >= tuMax)
+	{
+		// every step of a cheapest path is cheaper still, so a smaller budget is just a prefix.
+		for (std::vector<std::pair<int, int> >::const_iterator it = _reachable.tiles.begin(); it != _reachable.tiles.end() && it->first <= tuMax; ++it)
+		{
+			tiles.push_back(it->second);
+		}
+		return tiles;
+	}
+
 	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
 	{
 		it->reset();
@@ -1095,7 +1189,7 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 	startNode->connect(0, 0, 0);
 	PathfindingOpenSet unvisited;
 	unvisited.push(startNode);
-	std::vector<PathfindingNode*> reachable;
+	std::vector<std::pair<int, int> > reachable;
 	while (!unvisited.empty())
 	{
 		PathfindingNode *currentNode = unvisited.pop();
@@ -1123,14 +1217,32 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 			}
 		}
 		currentNode->setChecked();
-		reachable.push_back(currentNode);
+		if (currentNode != startNode)
+		{
+			reachable.push_back(std::make_pair(currentNode->getTUCost(false), _save->getTileIndex(currentPos)));
+		}
 	}
-	std::sort(reachable.begin(), reachable.end(), MinNodeCosts());
-	std::vector<int> tiles;
+	// order by cost, then by tile, so the result doesn't depend on how it was found.
+	std::sort(reachable.begin(), reachable.end());
+	reachable.insert(reachable.begin(), std::make_pair(0, _save->getTileIndex(start)));
+
 	tiles.reserve(reachable.size());
-	for (std::vector<PathfindingNode*>::const_iterator it = reachable.begin(); it != reachable.end(); ++it)
+	for (std::vector<std::pair<int, int> >::const_iterator it = reachable.begin(); it != reachable.end(); ++it)
+	{
+		tiles.push_back(it->second);
+	}
+
+	if (cacheable)
 	{
-		tiles.push_back(_save->getTileIndex((*it)->getPosition()));
+		_reachable.unit = unit;
+		_reachable.start = start;
+		_reachable.faction = unit->getFaction();
+		_reachable.movementType = _movementType;
+		_reachable.tuMax = tuMax;
+		_reachable.energyMax = energyMax;
+		_reachable.mapGeneration = Tile::getMapGeneration();
+		_reachable.spottingGeneration = BattleUnit::getSpottingGeneration();
+		_reachable.tiles.swap(reachable);
 	}
 	return tiles;
 }
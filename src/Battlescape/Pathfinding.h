@@ -20,6 +20,7 @@
 #define OPENXCOM_PATHFINDING_H
 
 #include <vector>
+#include <SDL_types.h>
 #include "Position.h"
 #include "PathfindingNode.h"
 #include "../Ruleset/MapData.h"
@@ -37,6 +38,14 @@ class BattleUnit;
 class Pathfinding
 {
 private:
+	/// The result of the last findReachable() call, along with what it depends on.
+	struct ReachableCache
+	{
+		BattleUnit *unit;
+		Position start;
+		int faction, movementType, tuMax, energyMax, mapGeneration, spottingGeneration;
+		std::vector<std::pair<int, int> > tiles; // TU cost and tile index, cheapest first
+	};
 	SavedBattleGame *_save;
 	std::vector<PathfindingNode> _nodes;
 	int _size;
@@ -46,6 +55,14 @@ private:
 	int _totalTUCost;
 	bool _modifierUsed;
 	MovementType _movementType;
+	ReachableCache _reachable;
+	std::vector<Uint16> _wallBlockage;
+	std::vector<int> _terrainVersions;
+	int _wallBlockageGeneration;
+	/// Invalidates the wall blockage of tiles around any terrain that changed.
+	void updateWallBlockage();
+	/// Determines whether walls block movement out of a tile in a direction, without caching.
+	bool isBlockedByWalls(Tile *startTile, const int direction, BattleUnit *missileTarget);
 	/// Gets the node at certain position.
 	PathfindingNode *getNode(const Position& pos);
 	/// Determines whether a tile blocks a certain movementType.
@@ -68,6 +85,8 @@ public:
 	static const int DIR_DOWN = 9;
 	enum bigWallTypes{ BLOCK = 1, BIGWALLNESW, BIGWALLNWSE, BIGWALLWEST, BIGWALLNORTH, BIGWALLEAST, BIGWALLSOUTH, BIGWALLEASTANDSOUTH};
 	static const int O_BIGWALL = -1;
+	static const int MOVEMENT_TYPES = 3;
+	static const Uint16 WALLS_KNOWN = 0x100;
 	/// Creates a new Pathfinding class.
 	Pathfinding(SavedBattleGame *save);
 	/// Cleans up the Pathfinding.
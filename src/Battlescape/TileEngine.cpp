@@ -21,6 +21,7 @@
 #include <cmath>
 #include <climits>
 #include <set>
+#include <algorithm>
 #include <functional>
 #include "TileEngine.h"
 #include <SDL.h>
@@ -111,49 +112,212 @@ void TileEngine::calculateSunShading(Tile *tile)
 
 /**
   * Recalculates lighting for the terrain: objects,items,fire.
+  * This rebuilds the light source registry from scratch.
   */
 void TileEngine::calculateTerrainLighting()
 {
 	const int layer = 1; // Static lighting layer.
-	const int fireLightPower = 15; // amount of light a fire generates
+	std::map<int, LightSource> *sources = _save->getLightSources();
 
 	// reset all light to 0 first
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
 	{
 		_save->getTiles()[i]->resetLight(layer);
 	}
+	sources->clear();
 
 	// add lighting of terrain
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
 	{
-		// only floors and objects can light up
-		if (_save->getTiles()[i]->getMapData(MapData::O_FLOOR)
-			&& _save->getTiles()[i]->getMapData(MapData::O_FLOOR)->getLightSource())
+		int power = getTerrainLightPower(_save->getTiles()[i]);
+		if (power > 0)
 		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(MapData::O_FLOOR)->getLightSource(), layer);
+			LightSource &source = (*sources)[i];
+			source.position = _save->getTiles()[i]->getPosition();
+			source.power = power;
+			addLight(source.position, power, layer, &source.litTiles);
 		}
-		if (_save->getTiles()[i]->getMapData(MapData::O_OBJECT)
-			&& _save->getTiles()[i]->getMapData(MapData::O_OBJECT)->getLightSource())
+	}
+}
+
+/**
+  * Recalculates terrain lighting after the light source on a tile changed
+  * (a flare was dropped or picked up, a fire started or went out, a lamp was destroyed).
+  * Only the tiles lit by that source are touched, instead of the whole map.
+  * @param tile The tile whose light source changed.
+  * @return Radius in tiles around the tile where the light changed, 0 if it didn't.
+  */
+int TileEngine::calculateTerrainLighting(Tile *tile)
+{
+	if (!tile)
+		return 0;
+
+	int reach = updateLightSource(tile);
+
+	if (Options::debug)
+	{
+		verifyTerrainLighting();
+	}
+	return reach;
+}
+
+/**
+  * Scans the map for light sources that have changed since they were registered,
+  * and recalculates terrain lighting for those sources only.
+  * @param center Position to measure the changed area from.
+  * @return Radius in tiles around the center that covers all the changed light, 0 if none changed.
+  */
+int TileEngine::updateTerrainLighting(const Position &center)
+{
+	std::map<int, LightSource> *sources = _save->getLightSources();
+	int radius = 0;
+
+	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+	{
+		std::map<int, LightSource>::const_iterator source = sources->find(i);
+		int oldPower = (source == sources->end()) ? 0 : source->second.power;
+		Tile *tile = _save->getTiles()[i];
+		if (getTerrainLightPower(tile) != oldPower)
 		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(MapData::O_OBJECT)->getLightSource(), layer);
+			int reach = updateLightSource(tile);
+			Position pos = tile->getPosition();
+			radius = std::max(radius, std::max(std::abs(pos.x - center.x), std::abs(pos.y - center.y)) + reach);
 		}
+	}
+
+	if (Options::debug)
+	{
+		verifyTerrainLighting();
+	}
+	return radius;
+}
 
-		// fires
-		if (_save->getTiles()[i]->getFire())
+/**
+  * Gets the power of the light a tile emits. Since light doesn't add up,
+  * only the brightest of the floor, object, fire and flares counts.
+  * @param tile The tile to check.
+  * @return Light power, 0 if the tile doesn't emit light.
+  */
+int TileEngine::getTerrainLightPower(Tile *tile)
+{
+	const int fireLightPower = 15; // amount of light a fire generates
+	int power = 0;
+
+	// only floors and objects can light up
+	if (tile->getMapData(MapData::O_FLOOR))
+	{
+		power = std::max(power, tile->getMapData(MapData::O_FLOOR)->getLightSource());
+	}
+	if (tile->getMapData(MapData::O_OBJECT))
+	{
+		power = std::max(power, tile->getMapData(MapData::O_OBJECT)->getLightSource());
+	}
+
+	// fires
+	if (tile->getFire())
+	{
+		power = std::max(power, fireLightPower);
+	}
+
+	for (std::vector<BattleItem*>::iterator it = tile->getInventory()->begin(); it != tile->getInventory()->end(); ++it)
+	{
+		if ((*it)->getRules()->getBattleType() == BT_FLARE)
 		{
-			addLight(_save->getTiles()[i]->getPosition(), fireLightPower, layer);
+			power = std::max(power, (*it)->getRules()->getPower());
 		}
+	}
+
+	return power;
+}
 
-		for (std::vector<BattleItem*>::iterator it = _save->getTiles()[i]->getInventory()->begin(); it != _save->getTiles()[i]->getInventory()->end(); ++it)
+/**
+  * Brings the registered light source of a tile up to date.
+  * A brighter source simply adds its light on top. A dimmer or removed source
+  * clears the tiles it lit, and the sources in reach of them are added back.
+  * @param tile The tile to update.
+  * @return Radius in tiles around the tile where the light changed, 0 if it didn't.
+  */
+int TileEngine::updateLightSource(Tile *tile)
+{
+	const int layer = 1; // Static lighting layer.
+	std::map<int, LightSource> *sources = _save->getLightSources();
+	int index = _save->getTileIndex(tile->getPosition());
+	int power = getTerrainLightPower(tile);
+	std::map<int, LightSource>::iterator old = sources->find(index);
+	int oldPower = (old == sources->end()) ? 0 : old->second.power;
+
+	if (power == oldPower)
+		return 0;
+
+	if (power < oldPower)
+	{
+		// take the old contribution away
+		for (std::vector<int>::const_iterator i = old->second.litTiles.begin(); i != old->second.litTiles.end(); ++i)
 		{
-			if ((*it)->getRules()->getBattleType() == BT_FLARE)
+			_save->getTiles()[*i]->resetLight(layer);
+		}
+		sources->erase(old);
+	}
+
+	if (power > 0)
+	{
+		LightSource &source = (*sources)[index];
+		source.position = tile->getPosition();
+		source.power = power;
+		source.litTiles.clear();
+		addLight(source.position, power, layer, &source.litTiles);
+	}
+
+	if (power < oldPower)
+	{
+		// let the neighbouring sources fill in the cleared area again, light doesn't add up so this is safe
+		Position center = tile->getPosition();
+		for (std::map<int, LightSource>::const_iterator i = sources->begin(); i != sources->end(); ++i)
+		{
+			if (i->first != index
+				&& std::abs(i->second.position.x - center.x) <= oldPower + i->second.power
+				&& std::abs(i->second.position.y - center.y) <= oldPower + i->second.power)
 			{
-				addLight(_save->getTiles()[i]->getPosition(), (*it)->getRules()->getPower(), layer);
+				addLight(i->second.position, i->second.power, layer);
 			}
 		}
+	}
+	return std::max(power, oldPower);
+}
+
+/**
+  * Compares the current terrain lighting with a full recalculation,
+  * logging any tiles that came out different. Used as a debug check
+  * on the incremental lighting, the full result is kept afterwards.
+  * @return True if both results are the same.
+  */
+bool TileEngine::verifyTerrainLighting()
+{
+	const int layer = 1; // Static lighting layer.
+	std::vector<int> incremental;
+	incremental.reserve(_save->getMapSizeXYZ());
 
+	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+	{
+		incremental.push_back(_save->getTiles()[i]->getLight(layer));
 	}
 
+	calculateTerrainLighting();
+
+	int mismatches = 0;
+	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+	{
+		if (_save->getTiles()[i]->getLight(layer) != incremental[i])
+		{
+			++mismatches;
+		}
+	}
+
+	if (mismatches)
+	{
+		Log(LOG_WARNING) << "Terrain lighting mismatch on " << mismatches << " tiles after incremental update.";
+	}
+	return mismatches == 0;
 }
 
 /**
@@ -191,29 +355,30 @@ void TileEngine::calculateUnitLighting()
  * @param center Center.
  * @param power Power.
  * @param layer Light is separated in 3 layers: Ambient, Static and Dynamic.
+ * @param litTiles If set, gets the indices of all the tiles that received light.
  */
-void TileEngine::addLight(const Position &center, int power, int layer)
+void TileEngine::addLight(const Position &center, int power, int layer, std::vector<int> *litTiles)
 {
-	// only loop through the positive quadrant.
-	for (int x = 0; x <= power; ++x)
+	for (int x = -power; x <= power; ++x)
 	{
-		for (int y = 0; y <= power; ++y)
+		for (int y = -power; y <= power; ++y)
 		{
+			int distance = int(floor(sqrt(float(x*x + y*y)) + 0.5));
+			if (distance >= power)
+				continue;
+
 			for (int z = 0; z < _save->getMapSizeZ(); z++)
 			{
-				int distance = int(floor(sqrt(float(x*x + y*y)) + 0.5));
-
-				if (_save->getTile(Position(center.x + x,center.y + y, z)))
-					_save->getTile(Position(center.x + x,center.y + y, z))->addLight(power - distance, layer);
-
-				if (_save->getTile(Position(center.x - x,center.y - y, z)))
-					_save->getTile(Position(center.x - x,center.y - y, z))->addLight(power - distance, layer);
-
-				if (_save->getTile(Position(center.x - x,center.y + y, z)))
-					_save->getTile(Position(center.x - x,center.y + y, z))->addLight(power - distance, layer);
-
-				if (_save->getTile(Position(center.x + x,center.y - y, z)))
-					_save->getTile(Position(center.x + x,center.y - y, z))->addLight(power - distance, layer);
+				Position pos = Position(center.x + x, center.y + y, z);
+				Tile *tile = _save->getTile(pos);
+				if (tile)
+				{
+					tile->addLight(power - distance, layer);
+					if (litTiles)
+					{
+						litTiles->push_back(_save->getTileIndex(pos));
+					}
+				}
 			}
 		}
 	}
@@ -232,13 +397,8 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 	int direction;
 	bool swap;
 	std::vector<Position> _trajectory;
-	if (Options::strafe && (unit->getTurretType() > -1)) {
-		direction = unit->getTurretDirection();
-	}
-	else
-	{
-		direction = unit->getDirection();
-	}
+	std::vector<int> columns;
+	direction = getViewDirection(unit);
 	swap = (direction==0 || direction==4);
 	int signX[8] = { +1, +1, +1, +1, -1, -1, -1, -1 };
 	int signY[8] = { -1, -1, -1, +1, +1, +1, -1, -1 };
@@ -248,7 +408,10 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 	unit->clearVisibleTiles();
 
 	if (unit->isOut())
+	{
+		setViewCone(unit, center, direction, 0);
 		return false;
+	}
 	Position pos = unit->getPosition();
 
 	if ((unit->getHeight() + unit->getFloatHeight() + -_save->getTile(unit->getPosition())->getTerrainLevel()) >= 24 + 4)
@@ -269,9 +432,18 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 		}
 		for (int y = y1; y <= y2; ++y)
 		{
+			const int distanceSqr = x*x + y*y;
+			if (distanceSqr <= MAX_VIEW_DISTANCE*MAX_VIEW_DISTANCE)
+			{
+				test.x = center.x + signX[direction]*(swap?y:x);
+				test.y = center.y + signY[direction]*(swap?x:y);
+				if (test.x >= 0 && test.x < _save->getMapSizeX() && test.y >= 0 && test.y < _save->getMapSizeY())
+				{
+					columns.push_back(test.y * _save->getMapSizeX() + test.x);
+				}
+			}
 			for (int z = 0; z < _save->getMapSizeZ(); z++)
 			{
-				const int distanceSqr = x*x + y*y;
 				test.z = z;
 				if (distanceSqr <= MAX_VIEW_DISTANCE*MAX_VIEW_DISTANCE)
 				{
@@ -337,6 +509,8 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 		}
 	}
 
+	setViewCone(unit, center, direction, &columns);
+
 	// we only react when there are at least the same amount of visible units as before AND the checksum is different
 	// this way we stop if there are the same amount of visible units, but a different unit is seen
 	// or we stop if there are more visible units seen
@@ -751,15 +925,92 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
 }
 
 /**
- * Calculates line of sight of a soldiers within range of the Position
- * (used when terrain has changed, which can reveal new parts of terrain or units).
+ * Gets the direction a unit is looking in, which is the turret direction for tanks when strafing is on.
+ * @param unit The unit to check.
+ * @return Direction.
+ */
+int TileEngine::getViewDirection(BattleUnit *unit) const
+{
+	if (Options::strafe && (unit->getTurretType() > -1))
+	{
+		return unit->getTurretDirection();
+	}
+	return unit->getDirection();
+}
+
+/**
+ * Updates the index of which units can see which map columns with a unit's new view cone.
+ * @param unit The unit that looked around.
+ * @param origin Position the unit looked from.
+ * @param direction Direction the unit looked in.
+ * @param columns Column indices (y * mapsize_x + x) inside the view cone, or 0 if the unit can't see anything.
+ */
+void TileEngine::setViewCone(BattleUnit *unit, const Position &origin, int direction, std::vector<int> *columns)
+{
+	if (_observers.empty())
+	{
+		_observers.resize(_save->getMapSizeX() * _save->getMapSizeY());
+	}
+
+	std::map<BattleUnit*, ViewCone>::iterator cone = _viewCones.find(unit);
+	if (cone != _viewCones.end())
+	{
+		for (std::vector<int>::const_iterator i = cone->second.columns.begin(); i != cone->second.columns.end(); ++i)
+		{
+			std::vector<BattleUnit*> &observers = _observers[*i];
+			observers.erase(std::find(observers.begin(), observers.end(), unit));
+		}
+		_viewCones.erase(cone);
+	}
+
+	if (columns)
+	{
+		ViewCone &newCone = _viewCones[unit];
+		newCone.origin = origin;
+		newCone.direction = direction;
+		newCone.columns.swap(*columns);
+		for (std::vector<int>::const_iterator i = newCone.columns.begin(); i != newCone.columns.end(); ++i)
+		{
+			_observers[*i].push_back(unit);
+		}
+	}
+}
+
+/**
+ * Calculates line of sight of the soldiers that can see the area around the Position
+ * (used when terrain has changed or a unit moved, which can reveal new parts of terrain or units).
+ * Only units whose view cone covers the area are recalculated, along with units
+ * nearby that moved or turned since they last looked around.
  * @param position Position of the changed terrain.
+ * @param radius Radius in tiles of the changed area around the position.
  */
-void TileEngine::calculateFOV(const Position &position)
+void TileEngine::calculateFOV(const Position &position, int radius)
 {
+	std::set<BattleUnit*> observers;
+	if (!_observers.empty())
+	{
+		for (int x = std::max(0, position.x - radius); x <= std::min(_save->getMapSizeX() - 1, position.x + radius); ++x)
+		{
+			for (int y = std::max(0, position.y - radius); y <= std::min(_save->getMapSizeY() - 1, position.y + radius); ++y)
+			{
+				std::vector<BattleUnit*> &column = _observers[y * _save->getMapSizeX() + x];
+				observers.insert(column.begin(), column.end());
+			}
+		}
+	}
+
 	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
 	{
-		if (distance(position, (*i)->getPosition()) < MAX_VIEW_DISTANCE)
+		bool recalculate = observers.find(*i) != observers.end();
+		if (!recalculate && distance(position, (*i)->getPosition()) < MAX_VIEW_DISTANCE + radius)
+		{
+			std::map<BattleUnit*, ViewCone>::const_iterator cone = _viewCones.find(*i);
+			recalculate = distance(position, (*i)->getPosition()) <= radius
+				|| cone == _viewCones.end()
+				|| cone->second.origin != (*i)->getPosition()
+				|| cone->second.direction != getViewDirection(*i);
+		}
+		if (recalculate)
 		{
 			calculateFOV(*i);
 		}
@@ -1085,8 +1336,9 @@ BattleUnit *TileEngine::hit(const Position &center, int power, ItemDamageType ty
 	}
 	applyGravity(tile);
 	calculateSunShading(); // roofs could have been destroyed
-	calculateTerrainLighting(); // fires could have been started
-	calculateFOV(center / Position(16,16,24));
+	// fires could have been started, lamps destroyed; units watching the relit area have to look again
+	Position centerTile = center / Position(16,16,24);
+	calculateFOV(centerTile, std::max(1, updateTerrainLighting(centerTile)));
 	return bu;
 }
 
@@ -1329,9 +1581,17 @@ void TileEngine::explode(const Position &center, int power, ItemDamageType type,
 		}
 	}
 
+	// units that can see any of the affected tiles have to look again
+	Position centerTile = center / Position(16,16,24);
+	int radius = 1;
+	for (std::set<Tile*>::iterator i = tilesAffected.begin(); i != tilesAffected.end(); ++i)
+	{
+		radius = std::max(radius, distance(centerTile, (*i)->getPosition()) + 1);
+	}
+
 	calculateSunShading(); // roofs could have been destroyed
-	calculateTerrainLighting(); // fires could have been started
-	calculateFOV(center / Position(16,16,24));
+	radius = std::max(radius, updateTerrainLighting(centerTile)); // fires could have been started, lamps destroyed
+	calculateFOV(centerTile, radius);
 }
 
 /**
@@ -1899,7 +2159,7 @@ int TileEngine::unitOpensDoor(BattleUnit *unit, bool rClick, int dir)
 		{
 			if (unit->spendTimeUnits(TUCost))
 			{
-				calculateFOV(unit->getPosition());
+				calculateFOV(unit->getPosition(), unit->getArmor()->getSize());
 				// look from the other side (may be need check reaction fire?)
 				std::vector<BattleUnit*> *vunits = unit->getVisibleUnits();
 				for (size_t i = 0; i < vunits->size(); ++i)
@@ -2292,20 +2552,24 @@ int TileEngine::voxelCheck(const Position& voxel, BattleUnit *excludeUnit, bool
 	}
 
 	// first we check terrain voxel data, not to allow 2x2 units stick through walls
-	for (int i=0; i< 4; ++i)
+	int index = _save->getTileIndex(tile->getPosition());
+	if (_voxelMapVersion.empty())
 	{
-		MapData *mp = tile->getMapData(i);
-		if (tile->isUfoDoorOpen(i))
-			continue;
-		if (mp != 0)
+		bakeVoxelMap();
+	}
+	else if (_voxelMapVersion[index] != tile->getTerrainVersion())
+	{
+		bakeVoxels(tile, index);
+	}
+	// only look up which part got hit when the baked row says something is there
+	if (_voxelMapState[index] == VOXELS_UFODOOR
+		|| (_voxelMapState[index] == VOXELS_BAKED
+			&& (_voxelMap[(index * VOXEL_LAYERS + (voxel.z%24)/2) * 16 + voxel.y%16] & (1 << (15 - voxel.x%16)))))
+	{
+		int part = terrainVoxelCheck(tile, voxel);
+		if (part != V_EMPTY)
 		{
-			int x = 15 - voxel.x%16;
-			int y = voxel.y%16;
-			int idx = (mp->getLoftID((voxel.z%24)/2)*16) + y;
-			if (_voxelData->at(idx) & (1 << x))
-			{
-				return i;
-			}
+			return part;
 		}
 	}
 
@@ -2346,6 +2610,101 @@ int TileEngine::voxelCheck(const Position& voxel, BattleUnit *excludeUnit, bool
 	return V_EMPTY;
 }
 
+/**
+ * Checks a voxel against the terrain of a tile, part by part.
+ * @param tile The tile the voxel is in.
+ * @param voxel The voxel to check.
+ * @return The tile part that occupies the voxel, or V_EMPTY.
+ */
+int TileEngine::terrainVoxelCheck(Tile *tile, const Position &voxel)
+{
+	for (int i=0; i< 4; ++i)
+	{
+		MapData *mp = tile->getMapData(i);
+		if (tile->isUfoDoorOpen(i))
+			continue;
+		if (mp != 0)
+		{
+			int x = 15 - voxel.x%16;
+			int y = voxel.y%16;
+			int idx = (mp->getLoftID((voxel.z%24)/2)*16) + y;
+			if (_voxelData->at(idx) & (1 << x))
+			{
+				return i;
+			}
+		}
+	}
+	return V_EMPTY;
+}
+
+/**
+ * Brings the baked terrain voxels of every tile up to date.
+ * Voxel checks bake stale tiles on the fly, so this has to be
+ * called before running them from several threads at once.
+ */
+void TileEngine::bakeVoxelMap()
+{
+	if (_voxelMapVersion.empty())
+	{
+		_voxelMap.resize(_save->getMapSizeXYZ() * VOXEL_LAYERS * 16);
+		_voxelMapVersion.resize(_save->getMapSizeXYZ(), -1);
+		_voxelMapState.resize(_save->getMapSizeXYZ());
+	}
+	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+	{
+		Tile *tile = _save->getTiles()[i];
+		if (_voxelMapVersion[i] != tile->getTerrainVersion())
+		{
+			bakeVoxels(tile, i);
+		}
+	}
+}
+
+/**
+ * Bakes the terrain of a tile into the voxel map: every voxel row of every
+ * LOFT layer becomes the union of the rows of all its parts, so most voxel
+ * checks are a single bit test. Ufo doors open and close as they animate,
+ * so tiles with one are always checked part by part.
+ * @param tile The tile to bake.
+ * @param index The tile's index.
+ */
+void TileEngine::bakeVoxels(Tile *tile, int index)
+{
+	Uint16 *rows = &_voxelMap[index * VOXEL_LAYERS * 16];
+	Uint16 any = 0;
+	bool ufoDoor = false;
+
+	std::fill(rows, rows + VOXEL_LAYERS * 16, 0);
+	for (int i = 0; i < 4; ++i)
+	{
+		MapData *mp = tile->getMapData(i);
+		if (mp == 0)
+			continue;
+		if (mp->isUFODoor())
+		{
+			ufoDoor = true;
+			continue;
+		}
+		for (int layer = 0; layer < VOXEL_LAYERS; ++layer)
+		{
+			int idx = mp->getLoftID(layer) * 16;
+			for (int y = 0; y < 16; ++y)
+			{
+				rows[layer * 16 + y] |= _voxelData->at(idx + y);
+				any |= rows[layer * 16 + y];
+			}
+		}
+	}
+
+	if (ufoDoor)
+		_voxelMapState[index] = VOXELS_UFODOOR;
+	else if (any)
+		_voxelMapState[index] = VOXELS_BAKED;
+	else
+		_voxelMapState[index] = VOXELS_EMPTY;
+	_voxelMapVersion[index] = tile->getTerrainVersion();
+}
+
 /**
  * Toggles personal lighting on / off.
  */
@@ -2419,7 +2778,7 @@ bool TileEngine::psiAttack(BattleAction *action)
 		else// if (action->type == BA_MINDCONTROL)
 		{
 			victim->convertToFaction(action->actor->getFaction());
-			calculateFOV(victim->getPosition());
+			calculateFOV(victim->getPosition(), victim->getArmor()->getSize());
 			calculateUnitLighting();
 			victim->setTimeUnits(victim->getStats()->tu);
 			victim->allowReselect();
@@ -20,6 +20,7 @@
 #define OPENXCOM_TILEENGINE_H
 
 #include <vector>
+#include <map>
 #include "Position.h"
 #include "../Ruleset/RuleItem.h"
 #include <SDL.h>
@@ -40,15 +41,36 @@ struct BattleAction;
 class TileEngine
 {
 private:
+	/// The map columns covered by a unit's last field of view calculation.
+	struct ViewCone
+	{
+		Position origin;
+		int direction;
+		std::vector<int> columns;
+	};
+	/// How much of a tile's terrain is in the baked voxel map.
+	enum VoxelMapState { VOXELS_EMPTY, VOXELS_BAKED, VOXELS_UFODOOR };
+	static const int VOXEL_LAYERS = 12; // LOFT layers per tile, each 2 voxels high
 	static const int MAX_VIEW_DISTANCE = 20;
 	static const int MAX_VOXEL_VIEW_DISTANCE = MAX_VIEW_DISTANCE * 16;
 	static const int MAX_DARKNESS_TO_SEE_UNITS = 9;
 	SavedBattleGame *_save;
 	std::vector<Uint16> *_voxelData;
+	std::vector<Uint16> _voxelMap;
+	std::vector<int> _voxelMapVersion;
+	std::vector<Uint8> _voxelMapState;
+	void bakeVoxels(Tile *tile, int index);
+	int terrainVoxelCheck(Tile *tile, const Position &voxel);
 	static const int heightFromCenter[11];
-	void addLight(const Position &center, int power, int layer);
+	void addLight(const Position &center, int power, int layer, std::vector<int> *litTiles = 0);
+	int getTerrainLightPower(Tile *tile);
+	int updateLightSource(Tile *tile);
 	int blockage(Tile *tile, const int part, ItemDamageType type, int direction = -1, bool checkingFromOrigin = false);
 	bool _personalLighting;
+	std::map<BattleUnit*, ViewCone> _viewCones;
+	std::vector< std::vector<BattleUnit*> > _observers;
+	int getViewDirection(BattleUnit *unit) const;
+	void setViewCone(BattleUnit *unit, const Position &origin, int direction, std::vector<int> *columns);
 public:
 	/// Creates a new TileEngine class.
 	TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData);
@@ -60,12 +82,18 @@ public:
 	void calculateSunShading(Tile *tile);
 	/// Calculates the field of view from a units view point.
 	bool calculateFOV(BattleUnit *unit);
-	/// Calculates the field of view within range of a certain position.
-	void calculateFOV(const Position &position);
+	/// Calculates the field of view of the units that can see a certain area.
+	void calculateFOV(const Position &position, int radius = 1);
 	/// Checks reaction fire.
 	bool checkReactionFire(BattleUnit *unit);
 	/// Recalculates lighting of the battlescape for terrain.
 	void calculateTerrainLighting();
+	/// Recalculates terrain lighting for the light source of a single tile.
+	int calculateTerrainLighting(Tile *tile);
+	/// Recalculates terrain lighting for every light source that changed.
+	int updateTerrainLighting(const Position &center);
+	/// Checks the terrain lighting against a full recalculation.
+	bool verifyTerrainLighting();
 	/// Recalculates lighting of the battlescape for units.
 	void calculateUnitLighting();
 	/// Handles bullet/weapon hits.
@@ -118,6 +146,8 @@ public:
 	bool isVoxelVisible(const Position& voxel);
 	/// Checks what type of voxel occupies this space.
 	int voxelCheck(const Position& voxel, BattleUnit *excludeUnit, bool excludeAllUnits = false, bool onlyVisible = false, BattleUnit *excludeAllBut = 0);
+	/// Brings the baked terrain voxels up to date for the whole map.
+	void bakeVoxelMap();
 	/// Blows this tile up.
 	bool detonate(Tile* tile);
 	/// Validates a throwing action.
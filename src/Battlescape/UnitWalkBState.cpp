@@ -189,7 +189,7 @@ void UnitWalkBState::think()
 			{
 				_unit->setVisible(false);
 			}
-			_terrain->calculateFOV(_unit->getPosition());
+			_terrain->calculateFOV(_unit->getPosition(), _unit->getArmor()->getSize());
 			unitSpotted = (!_falling && !_action.desperate && _parent->getPanicHandled() && _numUnitsSpotted != _unit->getUnitsSpottedThisTurn().size());
 
 			if (_parent->checkForProximityGrenades(_unit))
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "XcomBAIState.h"
+#include "TileEngine.h"
+#include "Pathfinding.h"
+#include "BattlescapeGame.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/BattleItem.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/Tile.h"
+#include "../Ruleset/RuleItem.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Sets up an XcomBAIState.
+ * @param save Pointer to the battle game.
+ * @param unit Pointer to the unit.
+ */
+XcomBAIState::XcomBAIState(SavedBattleGame *save, BattleUnit *unit) : BattleAIState(save, unit)
+{
+}
+
+/**
+ * Deletes the XcomBAIState.
+ */
+XcomBAIState::~XcomBAIState()
+{
+}
+
+/**
+ * Checks if a unit is an enemy of this unit.
+ * Civilians are left alone.
+ * @param unit Pointer to the unit to check.
+ * @return True if it's a living enemy.
+ */
+bool XcomBAIState::isEnemy(BattleUnit *unit) const
+{
+	return !unit->isOut() && unit->getFaction() != _unit->getFaction() && unit->getFaction() != FACTION_NEUTRAL;
+}
+
+/**
+ * Selects the closest enemy this unit can see.
+ * @return Pointer to the enemy, or 0 if none are in sight.
+ */
+BattleUnit *XcomBAIState::selectVisibleTarget() const
+{
+	BattleUnit *target = 0;
+	int closest = 0;
+	for (std::vector<BattleUnit*>::const_iterator i = _unit->getVisibleUnits()->begin(); i != _unit->getVisibleUnits()->end(); ++i)
+	{
+		if (isEnemy(*i))
+		{
+			int dist = _save->getTileEngine()->distance(_unit->getPosition(), (*i)->getPosition());
+			if (target == 0 || dist < closest)
+			{
+				target = *i;
+				closest = dist;
+			}
+		}
+	}
+	return target;
+}
+
+/**
+ * Selects the closest enemy on the map. Unlike the alien AI this
+ * doesn't bother with what the unit knows about, it just hunts.
+ * @return Pointer to the enemy, or 0 if there are none left.
+ */
+BattleUnit *XcomBAIState::selectNearestEnemy() const
+{
+	BattleUnit *target = 0;
+	int closest = 0;
+	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	{
+		if (isEnemy(*i))
+		{
+			int dist = _save->getTileEngine()->distance(_unit->getPosition(), (*i)->getPosition());
+			if (target == 0 || dist < closest)
+			{
+				target = *i;
+				closest = dist;
+			}
+		}
+	}
+	return target;
+}
+
+/**
+ * Shoots the closest visible enemy with the most accurate shot
+ * there's time for, or walks towards the nearest enemy.
+ * @param action Pointer to an action.
+ */
+void XcomBAIState::think(BattleAction *action)
+{
+	action->type = BA_NONE;
+	action->actor = _unit;
+	action->weapon = _unit->getMainHandWeapon(false);
+
+	int reserve = 0;
+	if (action->weapon && action->weapon->getRules()->getBattleType() == BT_FIREARM)
+	{
+		reserve = _unit->getActionTUs(BA_SNAPSHOT, action->weapon);
+		BattleUnit *target = selectVisibleTarget();
+		if (target)
+		{
+			const BattleActionType shots[] = { BA_AIMEDSHOT, BA_AUTOSHOT, BA_SNAPSHOT };
+			for (int i = 0; i < 3; ++i)
+			{
+				int tu = _unit->getActionTUs(shots[i], action->weapon);
+				if (tu > 0 && tu <= _unit->getTimeUnits())
+				{
+					action->type = shots[i];
+					action->TU = tu;
+					action->target = target->getPosition();
+					action->targeting = true;
+					return;
+				}
+			}
+			return;
+		}
+	}
+
+	BattleUnit *enemy = selectNearestEnemy();
+	if (enemy == 0)
+	{
+		return;
+	}
+	Position best = _unit->getPosition();
+	int closest = _save->getTileEngine()->distance(best, enemy->getPosition());
+	std::vector<int> reachable = _save->getPathfinding()->findReachable(_unit, _unit->getTimeUnits() - reserve);
+	for (std::vector<int>::const_iterator i = reachable.begin(); i != reachable.end(); ++i)
+	{
+		Position pos;
+		_save->getTileCoords(*i, &pos.x, &pos.y, &pos.z);
+		int dist = _save->getTileEngine()->distance(pos, enemy->getPosition());
+		if (dist < closest && _save->getTile(pos)->getUnit() == 0)
+		{
+			best = pos;
+			closest = dist;
+		}
+	}
+	if (best != _unit->getPosition())
+	{
+		action->type = BA_WALK;
+		action->target = best;
+	}
+}
+
+}
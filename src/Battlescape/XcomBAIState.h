@@ -0,0 +1,57 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_XCOMBAISTATE_H
+#define OPENXCOM_XCOMBAISTATE_H
+
+#include "BattleAIState.h"
+
+namespace OpenXcom
+{
+
+class SavedBattleGame;
+class BattleUnit;
+struct BattleAction;
+
+/**
+ * A simple AI for units on the player's side, so battles can be
+ * played out with nobody at the controls. Shoots the closest enemy
+ * in sight, otherwise closes in on the nearest enemy on the map
+ * while keeping enough time units for a snap shot.
+ */
+class XcomBAIState : public BattleAIState
+{
+private:
+	/// Checks if a unit is an enemy of this unit.
+	bool isEnemy(BattleUnit *unit) const;
+	/// Selects the closest enemy this unit can see.
+	BattleUnit *selectVisibleTarget() const;
+	/// Selects the closest enemy anywhere on the map.
+	BattleUnit *selectNearestEnemy() const;
+public:
+	/// Creates a new XcomBAIState linked to the game and a certain unit.
+	XcomBAIState(SavedBattleGame *save, BattleUnit *unit);
+	/// Cleans up the XcomBAIState.
+	~XcomBAIState();
+	/// Runs state functionality every AI cycle.
+	void think(BattleAction *action);
+};
+
+}
+
+#endif
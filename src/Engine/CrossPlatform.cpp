@@ -874,5 +874,22 @@ bool moveFile(const std::string &src, const std::string &dest)
 #endif
 }
 
+/**
+ * Gets the number of logical processors available
+ * to the game, for splitting work between threads.
+ * @return Processor count (at least 1).
+ */
+int getProcessorCount()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int count = info.dwNumberOfProcessors;
+#else
+	int count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return count > 0 ? count : 1;
+}
+
 }
 }
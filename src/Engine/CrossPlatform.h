@@ -77,6 +77,8 @@ namespace CrossPlatform
 	bool naturalCompare(const std::wstring &a, const std::wstring &b);
 	/// Move/rename a file between paths.
 	bool moveFile(const std::string &src, const std::string &dest);
+	/// Gets the number of processors available.
+	int getProcessorCount();
 }
 
 }
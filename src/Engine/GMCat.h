@@ -20,6 +20,7 @@
 #ifndef OPENXCOM_GMCAT_H
 #define OPENXCOM_GMCAT_H
 
+#include <vector>
 #include "CatFile.h"
 
 namespace OpenXcom
@@ -36,6 +37,8 @@ class GMCatFile : public CatFile
 public:
 	/// Inherit constructor.
 	GMCatFile(const char *path) : CatFile(path) { }
+	/// Converts a stream into a MIDI file.
+	bool convertMIDI(unsigned int i, std::vector<unsigned char> &midi);
 	/// Loads a stream as a MIDI file.
 	Music *loadMIDI(unsigned int i);
 };
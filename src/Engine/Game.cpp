@@ -34,6 +34,7 @@
 #include "Logger.h"
 #include "../Interface/Cursor.h"
 #include "../Interface/FpsCounter.h"
+#include "../Interface/Text.h"
 #include "../Resource/ResourcePack.h"
 #include "../Ruleset/Ruleset.h"
 #include "../Savegame/SavedGame.h"
@@ -43,6 +44,8 @@
 #include "InteractiveSurface.h"
 #include "Options.h"
 #include "CrossPlatform.h"
+#include "ThreadPool.h"
+#include "../Savegame/SaveWriter.h"
 #include "../Menu/TestState.h"
 #include "../Menu/OptionsBaseState.h"
 
@@ -132,6 +135,13 @@ Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _states
 	// Create blank language
 	_lang = new Language();
 
+	// Create worker threads
+	_threadPool = new ThreadPool(CrossPlatform::getProcessorCount());
+	_screen->setThreadPool(_threadPool);
+
+	// Create save writer
+	_saveWriter = new SaveWriter();
+
 	_framestarttime = 0;
 }
 
@@ -143,6 +153,9 @@ Game::~Game()
 	Sound::stop();
 	Music::stop();
 
+	// Finish writing any saves first
+	delete _saveWriter;
+
 	for (std::list<State*>::iterator i = _states.begin(); i != _states.end(); ++i)
 	{
 		delete *i;
@@ -152,11 +165,12 @@ Game::~Game()
 
 	delete _cursor;
 	delete _lang;
-	delete _res;
+	setResourcePack(0);
 	delete _rules;
 	delete _save;
 	delete _screen;
 	delete _fpsCounter;
+	delete _threadPool;
 
 	Mix_CloseAudio();
 
@@ -178,11 +192,7 @@ void Game::run()
 	while (!_quit)
 	{
 		// Clean up states
-		while (!_deleted.empty())
-		{
-			delete _deleted.back();
-			_deleted.pop_back();
-		}
+		cleanupStates();
 
 		// Initialize active state
 		if (!_init)
@@ -228,6 +238,10 @@ void Game::run()
 							break;
 					}
 					break;
+				case SDL_VIDEOEXPOSE:
+					// the window needs repainting even if the game hasn't changed
+					_screen->invalidate();
+					break;
 				case SDL_VIDEORESIZE:
 					if (Options::allowResize)
 					{
@@ -372,7 +386,7 @@ void Game::quit()
 	if (_save != 0 && _save->isIronman() && !_save->getName().empty())
 	{
 		std::string filename = CrossPlatform::sanitizeFilename(Language::wstrToFs(_save->getName())) + ".sav";
-		_save->save(filename);
+		_saveWriter->save(filename, _save->serialize());
 	}
 	_quit = true;
 }
@@ -432,6 +446,26 @@ FpsCounter *Game::getFpsCounter() const
 	return _fpsCounter;
 }
 
+/**
+ * Returns the pool of worker threads used to
+ * split heavy calculations between processors.
+ * @return Pointer to the ThreadPool.
+ */
+ThreadPool *Game::getThreadPool() const
+{
+	return _threadPool;
+}
+
+/**
+ * Returns the writer that saves games to disk
+ * in the background.
+ * @return Pointer to the SaveWriter.
+ */
+SaveWriter *Game::getSaveWriter() const
+{
+	return _saveWriter;
+}
+
 /**
  * Pops all the states currently in stack and pushes in the new state.
  * A shortcut for cleaning up all the old states when they're not necessary
@@ -472,6 +506,19 @@ void Game::popState()
 	_init = false;
 }
 
+/**
+ * Deletes all the states that have been popped
+ * off the stack since the last clean up.
+ */
+void Game::cleanupStates()
+{
+	while (!_deleted.empty())
+	{
+		delete _deleted.back();
+		_deleted.pop_back();
+	}
+}
+
 /**
  * Returns the language currently in use by the game.
  * @return Pointer to the language.
@@ -533,6 +580,12 @@ ResourcePack *Game::getResourcePack() const
  */
 void Game::setResourcePack(ResourcePack *res)
 {
+	// Text layouts are cached by font, which go away with the resources
+	if (_res != 0)
+	{
+		Log(LOG_DEBUG) << "Text layout cache: " << Text::getLayoutHits() << " hits, " << Text::getLayoutMisses() << " misses.";
+	}
+	Text::clearLayoutCache();
 	delete _res;
 	_res = res;
 }
@@ -596,6 +649,7 @@ void Game::loadRuleset()
 		throw Exception("Failed to load ruleset");
 	}
 	_rules->sortLists();
+	_rules->buildLocationGrids();
 }
 
 /**
@@ -34,6 +34,8 @@ class ResourcePack;
 class SavedGame;
 class Ruleset;
 class FpsCounter;
+class ThreadPool;
+class SaveWriter;
 
 /**
  * The core of the game engine, manages the game's entire contents and structure.
@@ -54,6 +56,8 @@ private:
 	Ruleset *_rules;
 	bool _quit, _init;
 	FpsCounter *_fpsCounter;
+	ThreadPool *_threadPool;
+	SaveWriter *_saveWriter;
 	bool _mouseActive;
 	unsigned int _framestarttime;
 	int _delaytime;
@@ -75,12 +79,18 @@ public:
 	Cursor *getCursor() const;
 	/// Gets the FpsCounter.
 	FpsCounter *getFpsCounter() const;
+	/// Gets the worker thread pool.
+	ThreadPool *getThreadPool() const;
+	/// Gets the background save writer.
+	SaveWriter *getSaveWriter() const;
 	/// Resets the state stack to a new state.
 	void setState(State *state);
 	/// Pushes a new state into the state stack.
 	void pushState(State *state);
 	/// Pops the last state from the state stack.
 	void popState();
+	/// Deletes the states that have been popped.
+	void cleanupStates();
 	/// Gets the currently loaded language.
 	Language *getLanguage() const;
 	/// Loads a new language for the game.
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Logger.h"
+#include <csignal>
+#include <cstdlib>
+#include <SDL.h>
+#include <SDL_thread.h>
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+// queued lines are written out at least this often (ms)...
+const Uint32 FLUSH_INTERVAL = 250;
+// ...or as soon as there's this many bytes
+const size_t FLUSH_SIZE = 64 * 1024;
+
+SDL_mutex *queueMutex = 0, *fileMutex = 0;
+SDL_cond *queueCond = 0;
+SDL_Thread *thread = 0;
+std::string queue, queueStderr;
+FILE *output = 0;
+bool quit = false;
+
+/**
+ * Writes out the queued lines. The queue is only
+ * locked long enough to take them, so logging never
+ * waits on the disk.
+ */
+void writeQueue()
+{
+	std::string lines, linesStderr;
+	SDL_LockMutex(fileMutex);
+	SDL_LockMutex(queueMutex);
+	lines.swap(queue);
+	linesStderr.swap(queueStderr);
+	SDL_UnlockMutex(queueMutex);
+	if (!linesStderr.empty())
+	{
+		fwrite(linesStderr.data(), 1, linesStderr.size(), stderr);
+		fflush(stderr);
+	}
+	if (!lines.empty())
+	{
+		if (output == 0)
+		{
+			output = fopen(Logger::logFile().c_str(), "a");
+		}
+		if (output != 0)
+		{
+			fwrite(lines.data(), 1, lines.size(), output);
+			fflush(output);
+		}
+	}
+	SDL_UnlockMutex(fileMutex);
+}
+
+/**
+ * Waits for lines to come in and writes them out in batches.
+ * @return Thread exit code.
+ */
+int writer(void *)
+{
+	SDL_LockMutex(queueMutex);
+	while (!quit)
+	{
+		if (queue.empty() && queueStderr.empty())
+		{
+			SDL_CondWait(queueCond, queueMutex);
+		}
+		else
+		{
+			// give the batch a chance to fill up
+			SDL_CondWaitTimeout(queueCond, queueMutex, FLUSH_INTERVAL);
+		}
+		SDL_UnlockMutex(queueMutex);
+		writeQueue();
+		SDL_LockMutex(queueMutex);
+	}
+	SDL_UnlockMutex(queueMutex);
+	return 0;
+}
+
+/**
+ * Writes out whatever is queued before the game dies.
+ * The locks might be held by the thread that crashed,
+ * so they're left alone, this is a last resort.
+ * @param sig Signal number.
+ */
+void crash(int sig)
+{
+	signal(sig, SIG_DFL);
+	if (output != 0 && !queue.empty())
+	{
+		fwrite(queue.data(), 1, queue.size(), output);
+		fflush(output);
+	}
+	raise(sig);
+}
+
+/**
+ * Sets up the queue and starts the log thread.
+ * This happens on the first line logged, which
+ * must come from the main thread.
+ */
+void start()
+{
+	queueMutex = SDL_CreateMutex();
+	fileMutex = SDL_CreateMutex();
+	queueCond = SDL_CreateCond();
+	thread = SDL_CreateThread(writer, 0);
+	atexit(Logger::close);
+	signal(SIGSEGV, crash);
+	signal(SIGABRT, crash);
+	signal(SIGFPE, crash);
+	signal(SIGILL, crash);
+}
+
+}
+
+/**
+ * Closes the current log file and starts a new empty one,
+ * everything logged so far goes to the old one.
+ * @param file Path to the log file.
+ * @return False if the log file couldn't be created.
+ */
+bool Logger::open(const std::string &file)
+{
+	if (queueMutex == 0)
+	{
+		start();
+	}
+	writeQueue();
+	SDL_LockMutex(fileMutex);
+	if (output != 0)
+	{
+		fclose(output);
+	}
+	logFile() = file;
+	output = fopen(file.c_str(), "w");
+	bool ok = (output != 0);
+	SDL_UnlockMutex(fileMutex);
+	return ok;
+}
+
+/**
+ * Adds a line to the log queue, with a timestamp. Errors are
+ * written out right away in case the game doesn't survive them.
+ * @param level Severity level of the line.
+ * @param line Line to log.
+ */
+void Logger::write(SeverityLevel level, const std::string &line)
+{
+	if (queueMutex == 0)
+	{
+		start();
+	}
+	SDL_LockMutex(queueMutex);
+	bool wasEmpty = queue.empty();
+	// now() isn't thread-safe
+	queue += "[" + now() + "]" + "\t" + line;
+	if (reportingLevel() == LOG_DEBUG)
+	{
+		queueStderr += line;
+	}
+	if (wasEmpty || queue.size() >= FLUSH_SIZE)
+	{
+		SDL_CondSignal(queueCond);
+	}
+	SDL_UnlockMutex(queueMutex);
+	if (level <= LOG_ERROR || thread == 0)
+	{
+		writeQueue();
+	}
+}
+
+/**
+ * Writes out all the queued lines before returning.
+ */
+void Logger::flush()
+{
+	if (queueMutex != 0)
+	{
+		writeQueue();
+	}
+}
+
+/**
+ * Stops the log thread and writes out whatever is
+ * left in the queue. Anything logged afterwards is
+ * written out straight away. Called on exit.
+ */
+void Logger::close()
+{
+	if (thread != 0)
+	{
+		SDL_LockMutex(queueMutex);
+		quit = true;
+		SDL_CondSignal(queueCond);
+		SDL_UnlockMutex(queueMutex);
+		SDL_WaitThread(thread, 0);
+		thread = 0;
+	}
+	flush();
+	if (output != 0)
+	{
+		SDL_LockMutex(fileMutex);
+		fclose(output);
+		output = 0;
+		SDL_UnlockMutex(fileMutex);
+	}
+}
+
+}
@@ -56,6 +56,8 @@ enum SeverityLevel
 /**
  * A basic logging and debugging class, prints output to stdout/files
  * and can capture stack traces of fatal errors too.
+ * Lines are queued up and written out in batches by a background
+ * thread, errors are written out straight away.
  * @note Wasn't really satisfied with any of the libraries around
  * so I rolled my own. Based on http://www.drdobbs.com/cpp/logging-in-c/201804215
  */
@@ -69,19 +71,29 @@ public:
     static SeverityLevel& reportingLevel();
 	static std::string& logFile();
     static std::string toString(SeverityLevel level);
+	/// Starts a new log file.
+	static bool open(const std::string &file);
+	/// Queues up a line for the log.
+	static void write(SeverityLevel level, const std::string &line);
+	/// Writes out all the queued lines.
+	static void flush();
+	/// Writes out all the queued lines and stops the log thread.
+	static void close();
 protected:
     std::ostringstream os;
+	SeverityLevel _level;
 private:
     Logger(const Logger&);
     Logger& operator =(const Logger&);
 };
 
-inline Logger::Logger()
+inline Logger::Logger() : _level(LOG_INFO)
 {
 }
 
 inline std::ostringstream& Logger::get(SeverityLevel level)
 {
+	_level = level;
 	os << "[" << toString(level) << "]" << "\t";
     return os;
 }
@@ -89,17 +101,7 @@ inline std::ostringstream& Logger::get(SeverityLevel level)
 inline Logger::~Logger()
 {
     os << std::endl;
-	if (reportingLevel() == LOG_DEBUG)
-	{
-		fprintf(stderr, "%s", os.str().c_str());
-		fflush(stderr);
-	}
-	std::ostringstream ss;
-	ss << "[" << now() << "]" << "\t" << os.str();
-	FILE *file = fopen(logFile().c_str(), "a");
-	fprintf(file, "%s", ss.str().c_str());
-    fflush(file);
-	fclose(file);
+	write(_level, os.str());
 }
 
 inline SeverityLevel& Logger::reportingLevel()
@@ -122,6 +122,7 @@ void create()
 	_info.push_back(OptionInfo("cursorInBlackBandsInWindow", &cursorInBlackBandsInWindow, true));
 	_info.push_back(OptionInfo("cursorInBlackBandsInBorderlessWindow", &cursorInBlackBandsInBorderlessWindow, false));
 	_info.push_back(OptionInfo("saveOrder", (int*)&saveOrder, SORT_DATE_DESC));
+	_info.push_back(OptionInfo("binarySaves", &binarySaves, false)); // true writes saves in the compact binary format
 	_info.push_back(OptionInfo("geoClockSpeed", &geoClockSpeed, 80));
 	_info.push_back(OptionInfo("dogfightSpeed", &dogfightSpeed, 20));
 	_info.push_back(OptionInfo("geoScrollSpeed", &geoScrollSpeed, 20));
@@ -372,14 +373,10 @@ bool init(int argc, char *argv[])
 
 	std::string s = getUserFolder();
 	s += "openxcom.log";
-	Logger::logFile() = s;
-	FILE *file = fopen(Logger::logFile().c_str(), "w");
-	if (!file)
+	if (!Logger::open(s))
 	{
 		throw Exception(s + " not found");
 	}
-	fflush(file);
-	fclose(file);
 	Log(LOG_INFO) << "Data folder is: " << _dataFolder;
 	Log(LOG_INFO) << "Data search is: ";
 	for (std::vector<std::string>::iterator i = _dataList.begin(); i != _dataList.end(); ++i)
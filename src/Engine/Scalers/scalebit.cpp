@@ -501,3 +501,68 @@ void scale(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_
 	}
 }
 
+/**
+ * Apply the Scale effect on a horizontal band of a bitmap.
+ * The result is the same as the matching rows of ::scale(), so a bitmap
+ * can be split in bands that are scaled independently, for example on
+ * different threads. The rows just outside the band are read but not written.
+ * \param scale Scale factor. 2, 3 or 4.
+ * \param void_dst Pointer at the first pixel of the whole destination bitmap.
+ * \param dst_slice Size in bytes of a destination bitmap row.
+ * \param void_src Pointer at the first pixel of the whole source bitmap.
+ * \param src_slice Size in bytes of a source bitmap row.
+ * \param pixel Bytes per pixel of the source and destination bitmap.
+ * \param width Horizontal size in pixels of the source bitmap.
+ * \param height Vertical size in pixels of the source bitmap.
+ * \param begin First source row of the band.
+ * \param end Source row after the last one of the band.
+ */
+void scale_rows(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_src, unsigned src_slice, unsigned pixel, unsigned width, unsigned height, unsigned begin, unsigned end)
+{
+	unsigned char* dst = (unsigned char*)void_dst;
+	const unsigned char* src = (const unsigned char*)void_src;
+	unsigned y;
+
+	if (begin >= end)
+		return;
+
+	switch (scale) {
+	case 2 :
+		for (y = begin; y < end; ++y) {
+			stage_scale2x(SCDST(2 * y), SCDST(2 * y + 1), SCSRC(y > 0 ? y - 1 : 0), SCSRC(y), SCSRC(y + 1 < height ? y + 1 : height - 1), pixel, width);
+		}
+		break;
+	case 3 :
+		for (y = begin; y < end; ++y) {
+			stage_scale3x(SCDST(3 * y), SCDST(3 * y + 1), SCDST(3 * y + 2), SCSRC(y > 0 ? y - 1 : 0), SCSRC(y), SCSRC(y + 1 < height ? y + 1 : height - 1), pixel, width);
+		}
+		break;
+	case 4 : {
+		/* scale the band plus one row on each side to 2x, then scale that to 4x */
+		unsigned mid_slice = (2 * pixel * width + 0x7) & ~0x7;
+		unsigned mid_begin = begin > 0 ? begin - 1 : 0;
+		unsigned mid_end = end < height ? end + 1 : height;
+		unsigned char* mid = (unsigned char*)malloc(2 * (mid_end - mid_begin) * mid_slice);
+		unsigned mid_height = 2 * height;
+
+		if (!mid)
+			return;
+
+#define SCBAND(i) (mid + ((i) - 2 * mid_begin) * mid_slice)
+		for (y = mid_begin; y < mid_end; ++y) {
+			stage_scale2x(SCBAND(2 * y), SCBAND(2 * y + 1), SCSRC(y > 0 ? y - 1 : 0), SCSRC(y), SCSRC(y + 1 < height ? y + 1 : height - 1), pixel, width);
+		}
+		for (y = 2 * begin; y < 2 * end; ++y) {
+			stage_scale2x(SCDST(2 * y), SCDST(2 * y + 1), SCBAND(y > 0 ? y - 1 : 0), SCBAND(y), SCBAND(y + 1 < mid_height ? y + 1 : mid_height - 1), pixel, 2 * width);
+		}
+#undef SCBAND
+
+		free(mid);
+		break;
+	}
+	}
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	scale2x_mmx_emms();
+#endif
+}
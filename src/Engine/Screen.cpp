@@ -18,6 +18,7 @@
  */
 #include "Screen.h"
 #include <sstream>
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <limits.h>
@@ -107,7 +108,7 @@ void Screen::makeVideoFlags()
  * Initializes a new display screen for the game to render contents to.
  * The screen is set up based on the current options.
  */
-Screen::Screen() : _baseWidth(ORIGINAL_WIDTH), _baseHeight(ORIGINAL_HEIGHT), _scaleX(1.0), _scaleY(1.0), _numColors(0), _firstColor(0), _pushPalette(false), _surface(0)
+Screen::Screen() : _baseWidth(ORIGINAL_WIDTH), _baseHeight(ORIGINAL_HEIGHT), _scaleX(1.0), _scaleY(1.0), _numColors(0), _firstColor(0), _pushPalette(false), _surface(0), _threadPool(0), _redrawAll(true)
 {
 	resetDisplay();	
 	memset(deferredPalette, 0, 256*sizeof(SDL_Color));
@@ -180,16 +181,71 @@ void Screen::handle(Action *action)
  * If the scaling factor is bigger than 1, the entire contents
  * of the buffer are resized by that factor (eg. 2 = doubled)
  * before being put on screen.
+ * The buffer is compared with the last frame shown, so only
+ * the rows that changed are scaled and updated, and frames
+ * where nothing changed don't touch the display at all.
  */
 void Screen::flip()
 {
+	// find the rows that changed since the last frame
+	SDL_Surface *buffer = _surface->getSurface();
+	const size_t rowSize = buffer->w * buffer->format->BytesPerPixel;
+	if (_lastFrame.size() != rowSize * buffer->h)
+	{
+		_lastFrame.assign(rowSize * buffer->h, 0);
+		_redrawAll = true;
+	}
+	int firstRow = buffer->h, lastRow = 0;
+	for (int y = 0; y < buffer->h; ++y)
+	{
+		Uint8 *row = (Uint8*)buffer->pixels + y * buffer->pitch;
+		Uint8 *last = &_lastFrame[y * rowSize];
+		if (memcmp(row, last, rowSize) != 0)
+		{
+			memcpy(last, row, rowSize);
+			firstRow = std::min(firstRow, y);
+			lastRow = y + 1;
+		}
+	}
+	if (!_redrawAll && firstRow >= lastRow)
+	{
+		return;
+	}
+
+	// single-buffered software displays keep what was drawn
+	// before, so only the changed part needs to be updated
+	const bool partial = !_redrawAll && !isOpenGLEnabled() && !(_screen->flags & SDL_DOUBLEBUF) &&
+		_topBlackBand <= 0 && _bottomBlackBand <= 0 && _leftBlackBand <= 0 && _rightBlackBand <= 0;
+	if (partial)
+	{
+		// filters look at the rows around each pixel, so they spill over
+		int top = (std::max(firstRow - Zoom::FILTER_MARGIN, 0) * getHeight()) / _baseHeight;
+		int bottom = std::min(((lastRow + Zoom::FILTER_MARGIN) * getHeight() + _baseHeight - 1) / _baseHeight, getHeight());
+		if (getWidth() != _baseWidth || getHeight() != _baseHeight)
+		{
+			Zoom::flipWithZoom(buffer, _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput, _threadPool, firstRow, lastRow);
+		}
+		else
+		{
+			SDL_Rect rect = {0, (Sint16)firstRow, (Uint16)buffer->w, (Uint16)(lastRow - firstRow)};
+			SDL_BlitSurface(buffer, &rect, _screen, &rect);
+			top = firstRow;
+			bottom = lastRow;
+		}
+		SDL_UpdateRect(_screen, 0, top, getWidth(), bottom - top);
+		return;
+	}
+
+	if (_screen->flags & SDL_SWSURFACE) memset(_screen->pixels, 0, _screen->h*_screen->pitch);
+	else SDL_FillRect(_screen, &_clear, 0);
+
 	if (getWidth() != _baseWidth || getHeight() != _baseHeight || isOpenGLEnabled())
 	{
-		Zoom::flipWithZoom(_surface->getSurface(), _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput);
+		Zoom::flipWithZoom(buffer, _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput, _threadPool);
 	}
 	else
 	{
-		SDL_BlitSurface(_surface->getSurface(), 0, _screen, 0);
+		SDL_BlitSurface(buffer, 0, _screen, 0);
 	}
 
 	// perform any requested palette update
@@ -209,16 +265,36 @@ void Screen::flip()
 	{
 		throw Exception(SDL_GetError());
 	}
+	_redrawAll = false;
 }
 
 /**
  * Clears all the contents out of the internal buffer.
+ * The display itself is cleared on the next full redraw.
  */
 void Screen::clear()
 {
 	_surface->clear();
-	if (_screen->flags & SDL_SWSURFACE) memset(_screen->pixels, 0, _screen->h*_screen->pitch);
-	else SDL_FillRect(_screen, &_clear, 0);
+}
+
+/**
+ * Forgets what's on the display, so the next flip
+ * redraws the whole screen even if nothing changed,
+ * eg. when the window was covered up.
+ */
+void Screen::invalidate()
+{
+	_redrawAll = true;
+}
+
+/**
+ * Lets the screen share out the scaling of
+ * each frame between a set of worker threads.
+ * @param pool Pointer to the thread pool.
+ */
+void Screen::setThreadPool(ThreadPool *pool)
+{
+	_threadPool = pool;
 }
 
 /**
@@ -245,6 +321,8 @@ void Screen::setPalette(SDL_Color* colors, int firstcolor, int ncolors, bool imm
 	}
 
 	_surface->setPalette(colors, firstcolor, ncolors);
+	// the buffer looks the same, but it'll come out in different colors
+	_redrawAll = true;
 
 	// defer actual update of screen until SDL_Flip()
 	if (immediately && _screen->format->BitsPerPixel == 8 && SDL_SetColors(_screen, colors, firstcolor, ncolors) == 0)
@@ -303,6 +381,7 @@ int Screen::getHeight() const
  */
 void Screen::resetDisplay(bool resetVideo)
 {
+	_redrawAll = true;
 	int width = Options::displayWidth;
 	int height = Options::displayHeight;
 #ifdef __linux__
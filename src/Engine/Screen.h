@@ -21,6 +21,7 @@
 
 #include <SDL.h>
 #include <string>
+#include <vector>
 #include "OpenGL.h"
 
 namespace OpenXcom
@@ -28,6 +29,7 @@ namespace OpenXcom
 
 class Surface;
 class Action;
+class ThreadPool;
 
 /**
  * A display screen, handles rendering onto the game window.
@@ -53,6 +55,9 @@ private:
 	OpenGL glOutput;
 	Surface *_surface;
 	SDL_Rect _clear;
+	ThreadPool *_threadPool;
+	std::vector<Uint8> _lastFrame;
+	bool _redrawAll;
 	/// Sets the _flags and _bpp variables based on game options; needed in more than one place now
 	void makeVideoFlags();
 public:
@@ -73,6 +78,10 @@ public:
 	void flip();
 	/// Clears the screen.
 	void clear();
+	/// Sets the threads used to scale the screen.
+	void setThreadPool(ThreadPool *pool);
+	/// Makes the next flip redraw the whole screen.
+	void invalidate();
 	/// Sets the screen's 8bpp palette.
 	void setPalette(SDL_Color *colors, int firstcolor = 0, int ncolors = 256, bool immediately = false);
 	/// Gets the screen's 8bpp palette.
@@ -156,6 +156,36 @@ Surface::Surface(int width, int height, int x, int y, int bpp) : _x(x), _y(y), _
 	_clear.h = getHeight();
 }
 
+/**
+ * Sets up an 8bpp surface that draws straight into memory
+ * owned by someone else, like a frame inside a sprite atlas.
+ * The memory must be laid out with the same padded pitch as
+ * a regular surface and outlive this one.
+ * @param width Width in pixels.
+ * @param height Height in pixels.
+ * @param pixels Pointer to the first pixel.
+ */
+Surface::Surface(int width, int height, Uint8 *pixels) : _x(0), _y(0), _visible(true), _hidden(false), _redraw(false), _alignedBuffer(0)
+{
+	_surface = SDL_CreateRGBSurfaceFrom(pixels, width, height, 8, GetPitch(8, width), 0, 0, 0, 0);
+
+	if (_surface == 0)
+	{
+		throw Exception(SDL_GetError());
+	}
+
+	SDL_SetColorKey(_surface, SDL_SRCCOLORKEY, 0);
+
+	_crop.w = 0;
+	_crop.h = 0;
+	_crop.x = 0;
+	_crop.y = 0;
+	_clear.x = 0;
+	_clear.y = 0;
+	_clear.w = getWidth();
+	_clear.h = getHeight();
+}
+
 /**
  * Performs a deep copy of an existing surface.
  * @param other Surface to copy from.
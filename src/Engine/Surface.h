@@ -50,6 +50,8 @@ protected:
 public:
 	/// Creates a new surface with the specified size and position.
 	Surface(int width, int height, int x = 0, int y = 0, int bpp = 8);
+	/// Creates a new 8bpp surface over existing pixel memory.
+	Surface(int width, int height, Uint8 *pixels);
 	/// Creates a new surface from an existing one.
 	Surface(const Surface& other);
 	/// Cleans up the surface.
@@ -30,7 +30,7 @@ namespace OpenXcom
  * @param width Frame width in pixels.
  * @param height Frame height in pixels.
  */
-SurfaceSet::SurfaceSet(int width, int height) : _width(width), _height(height), _frames()
+SurfaceSet::SurfaceSet(int width, int height) : _width(width), _height(height), _frames(), _atlas(0)
 {
 
 }
@@ -43,10 +43,30 @@ SurfaceSet::SurfaceSet(const SurfaceSet& other)
 {
 	_width = other._width;
 	_height = other._height;
+	_pck = other._pck;
+	_pckOffsets = other._pckOffsets;
+	_palette = other._palette;
+	_paletteSet = other._paletteSet;
+	_atlas = other._atlas ? new Surface(*other._atlas) : 0;
 	
 	for (std::map<int, Surface*>::const_iterator f = other._frames.begin(); f != other._frames.end(); ++f)
 	{
-		_frames[f->first] = new Surface(*f->second);
+		if (f->second == 0)
+		{
+			// frames that were never decoded stay that way
+			_frames[f->first] = 0;
+		}
+		else if (other._atlas && f->second->getSurface()->pixels == other.getAtlasFrame(f->first))
+		{
+			// the pixels came along with the atlas
+			Surface *surface = new Surface(_width, _height, getAtlasFrame(f->first));
+			surface->setPalette(f->second->getPalette());
+			_frames[f->first] = surface;
+		}
+		else
+		{
+			_frames[f->first] = new Surface(*f->second);
+		}
 	}
 }
 
@@ -59,6 +79,7 @@ SurfaceSet::~SurfaceSet()
 	{
 		delete i->second;
 	}
+	delete _atlas;
 }
 
 /**
@@ -66,6 +87,9 @@ SurfaceSet::~SurfaceSet()
  * into the surface. The PCK file contains an RLE compressed
  * image, while the TAB file contains the offsets to each
  * frame in the image.
+ * The PCK is read in one go and only scanned for where each
+ * frame starts, the frames themselves are decoded the first
+ * time they're asked for, since most sets are only partly used.
  * @param pck Filename of the PCK image.
  * @param tab Filename of the TAB offsets.
  * @sa http://www.ufopaedia.org/index.php?title=Image_Formats#PCK
@@ -82,69 +106,134 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 		{
 			throw Exception(tab + " not found");
 		}
-		Uint16 off;
-		while (offsetFile.read((char*) &off, sizeof(off)))
-		{
-			off = SDL_SwapLE16(off);
-			Surface *surface = new Surface(_width, _height);
-			_frames[nframes] = surface;
-			nframes++;
-		}
+		// the offsets are only 16-bit, so the real ones come from the PCK itself
+		offsetFile.seekg(0, std::ios::end);
+		nframes = (int)offsetFile.tellg() / sizeof(Uint16);
 		offsetFile.close();
 	}
 	else
 	{
 		nframes = 1;
-		Surface *surface = new Surface(_width, _height);
-		_frames[0] = surface;
 	}
 
-	// Load PCX and put pixels in surfaces
+	// Load PCK data
 	std::ifstream imgFile (pck.c_str(), std::ios::in | std::ios::binary);
 	if (!imgFile)
 	{
 		throw Exception(pck + " not found");
 	}
-
-	Uint8 value;
-
-	for (int frame = 0; frame < nframes; frame++)
+	imgFile.seekg(0, std::ios::end);
+	std::streamoff size = imgFile.tellg();
+	imgFile.seekg(0, std::ios::beg);
+	_pck.resize((size_t)size);
+	if (size > 0)
 	{
-		int x = 0, y = 0;
+		imgFile.read((char*)&_pck[0], size);
+	}
+	imgFile.close();
 
-		// Lock the surface
-		_frames[frame]->lock();
+	// Frames are decoded straight into the atlas, so the pixels of a set
+	// are packed together instead of spread over an allocation each
+	for (std::map<int, Surface*>::iterator i = _frames.begin(); i != _frames.end(); ++i)
+	{
+		delete i->second;
+	}
+	_frames.clear();
+	delete _atlas;
+	_atlas = nframes > 0 ? new Surface(_width, _height * nframes) : 0;
+
+	// Find where each frame starts: a row count, then pixels
+	// and 254 skips with their length, up to a 255 terminator
+	_pckOffsets.assign(nframes, _pck.size());
+	size_t pos = 0;
+	for (int frame = 0; frame < nframes; ++frame)
+	{
+		_frames[frame] = 0;
+		if (pos >= _pck.size())
+			continue;
+		_pckOffsets[frame] = pos++;
+		while (pos < _pck.size() && _pck[pos] != 255)
+		{
+			pos += (_pck[pos] == 254) ? 2 : 1;
+		}
+		++pos;
+	}
+}
 
-		imgFile.read((char*)&value, 1);
-		for (int i = 0; i < value; ++i)
+/**
+ * Decodes a frame of the loaded PCK data into a new surface.
+ * @param i Frame number in the set.
+ * @return Pointer to the new surface.
+ */
+Surface *SurfaceSet::decodeFrame(int i)
+{
+	Surface *surface = new Surface(_width, _height, getAtlasFrame(i));
+	for (int color = 0; color < (int)_paletteSet.size(); ++color)
+	{
+		// apply the colors in runs, as they were set on the set
+		int end = color;
+		while (end < (int)_paletteSet.size() && _paletteSet[end])
+			++end;
+		if (end > color)
 		{
-			for (int j = 0; j < _width; ++j)
-			{
-				_frames[frame]->setPixelIterative(&x, &y, 0);
-			}
+			surface->setPalette(&_palette[color], color, end - color);
+			color = end;
 		}
+	}
 
-		while (imgFile.read((char*)&value, 1) && value != 255)
+	SDL_Surface *s = surface->getSurface();
+	const int total = _width * _height;
+	size_t pos = _pckOffsets[i];
+	if (pos < _pck.size())
+	{
+		surface->lock();
+		Uint8 *pixels = (Uint8*)s->pixels;
+		// pixels start out transparent, so skipped ones are left as they are
+		int pixel = _pck[pos++] * _width;
+		while (pos < _pck.size() && _pck[pos] != 255)
 		{
+			Uint8 value = _pck[pos++];
 			if (value == 254)
 			{
-				imgFile.read((char*)&value, 1);
-				for (int i = 0; i < value; ++i)
-				{
-					_frames[frame]->setPixelIterative(&x, &y, 0);
-				}
+				if (pos < _pck.size())
+					pixel += _pck[pos++];
 			}
 			else
 			{
-				_frames[frame]->setPixelIterative(&x, &y, value);
+				if (pixel < total)
+					pixels[(pixel / _width) * s->pitch + pixel % _width] = value;
+				++pixel;
 			}
 		}
-
-		// Unlock the surface
-		_frames[frame]->unlock();
+		surface->unlock();
 	}
+	return surface;
+}
 
-	imgFile.close();
+/**
+ * Returns where a frame's pixels start inside the atlas.
+ * @param i Frame number in the set.
+ * @return Pointer to the first pixel of the frame.
+ */
+Uint8 *SurfaceSet::getAtlasFrame(int i) const
+{
+	SDL_Surface *atlas = _atlas->getSurface();
+	return (Uint8*)atlas->pixels + i * _height * atlas->pitch;
+}
+
+/**
+ * Decodes every frame that hasn't been used yet, for
+ * code that needs to go through all of them.
+ */
+void SurfaceSet::decodeAll()
+{
+	for (std::map<int, Surface*>::iterator i = _frames.begin(); i != _frames.end(); ++i)
+	{
+		if (i->second == 0)
+		{
+			i->second = decodeFrame(i->first);
+		}
+	}
 }
 
 /**
@@ -214,9 +303,14 @@ void SurfaceSet::loadDat(const std::string &filename)
  */
 Surface *SurfaceSet::getFrame(int i)
 {
-	if (_frames.find(i) != _frames.end())
+	std::map<int, Surface*>::iterator frame = _frames.find(i);
+	if (frame != _frames.end())
 	{
-		return _frames[i];
+		if (frame->second == 0)
+		{
+			frame->second = decodeFrame(i);
+		}
+		return frame->second;
 	}
 	return 0;
 }
@@ -268,14 +362,30 @@ int SurfaceSet::getTotalFrames() const
  */
 void SurfaceSet::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 {
+	_palette.resize(256);
+	_paletteSet.resize(256, false);
+	for (int i = 0; i < ncolors && firstcolor + i < 256; ++i)
+	{
+		_palette[firstcolor + i] = colors[i];
+		_paletteSet[firstcolor + i] = true;
+	}
 	for (std::map<int, Surface*>::iterator i = _frames.begin(); i != _frames.end(); ++i)
 	{
-		(*i).second->setPalette(colors, firstcolor, ncolors);
+		if ((*i).second != 0)
+		{
+			(*i).second->setPalette(colors, firstcolor, ncolors);
+		}
 	}
 }
 
+/**
+ * Returns all the frames in the set, decoding any
+ * that haven't been used yet.
+ * @return Pointer to the map of frames.
+ */
 std::map<int, Surface*> *SurfaceSet::getFrames()
 {
+	decodeAll();
 	return &_frames;
 }
 }
@@ -40,6 +40,18 @@ class SurfaceSet
 private:
 	int _width, _height;
 	std::map<int, Surface*> _frames;
+	///one block holding the pixels of every PCK frame, one after the other
+	Surface *_atlas;
+	///compressed PCK data and where each frame starts in it, for frames not decoded yet
+	std::vector<Uint8> _pck;
+	std::vector<size_t> _pckOffsets;
+	///colors set on the whole set so far, applied to frames as they're decoded
+	std::vector<SDL_Color> _palette;
+	std::vector<bool> _paletteSet;
+	/// Gets the start of a frame inside the atlas.
+	Uint8 *getAtlasFrame(int i) const;
+	/// Decodes a frame of the PCK data.
+	Surface *decodeFrame(int i);
 public:
 	/// Crates a surface set with frames of the specified size.
 	SurfaceSet(int width, int height);
@@ -51,6 +63,8 @@ public:
 	void loadPck(const std::string &pck, const std::string &tab = "");
 	/// Loads an X-Com DAT image file.
 	void loadDat(const std::string &filename);
+	/// Decodes all the frames that haven't been used yet.
+	void decodeAll();
 	/// Gets a particular frame from the set.
 	Surface *getFrame(int i);
 	/// Creates a new surface and returns a pointer to it.
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ThreadPool.h"
+#include "Logger.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Starts the worker threads. The thread handing out
+ * the work runs jobs too, so one less is started.
+ * @param threads Total number of threads to use.
+ */
+ThreadPool::ThreadPool(int threads) : _job(0), _data(0), _next(0), _count(0), _running(0), _quit(false)
+{
+	_mutex = SDL_CreateMutex();
+	_wake = SDL_CreateCond();
+	_done = SDL_CreateCond();
+	for (int i = 1; i < threads; ++i)
+	{
+		SDL_Thread *thread = SDL_CreateThread(worker, (void*)this);
+		if (thread == 0)
+		{
+			Log(LOG_WARNING) << "Failed to start worker thread: " << SDL_GetError();
+			break;
+		}
+		_threads.push_back(thread);
+	}
+}
+
+/**
+ * Wakes up all the worker threads so they can quit,
+ * and waits for them.
+ */
+ThreadPool::~ThreadPool()
+{
+	SDL_LockMutex(_mutex);
+	_quit = true;
+	SDL_CondBroadcast(_wake);
+	SDL_UnlockMutex(_mutex);
+	for (std::vector<SDL_Thread*>::iterator i = _threads.begin(); i != _threads.end(); ++i)
+	{
+		SDL_WaitThread(*i, 0);
+	}
+	SDL_DestroyCond(_done);
+	SDL_DestroyCond(_wake);
+	SDL_DestroyMutex(_mutex);
+}
+
+/**
+ * Sleeps until there's work to do, and does it.
+ * @param pool Pointer to the thread pool.
+ * @return Thread exit code.
+ */
+int ThreadPool::worker(void *pool)
+{
+	ThreadPool *self = (ThreadPool*)pool;
+	SDL_LockMutex(self->_mutex);
+	while (true)
+	{
+		while (!self->_quit && self->_next >= self->_count)
+		{
+			SDL_CondWait(self->_wake, self->_mutex);
+		}
+		if (self->_quit)
+		{
+			break;
+		}
+		self->runJobs();
+	}
+	SDL_UnlockMutex(self->_mutex);
+	return 0;
+}
+
+/**
+ * Takes jobs one at a time until they've all been handed out.
+ * Must be called with the mutex locked, which is released
+ * while the jobs run.
+ */
+void ThreadPool::runJobs()
+{
+	while (_next < _count)
+	{
+		int index = _next++;
+		++_running;
+		SDL_UnlockMutex(_mutex);
+		_job(_data, index);
+		SDL_LockMutex(_mutex);
+		--_running;
+	}
+	if (_running == 0)
+	{
+		SDL_CondBroadcast(_done);
+	}
+}
+
+/**
+ * Gets the number of threads that share the work,
+ * including the one handing it out.
+ * @return Thread count.
+ */
+int ThreadPool::getThreadCount() const
+{
+	return _threads.size() + 1;
+}
+
+/**
+ * Runs a job once for every index from 0 to count-1, spread
+ * over all the threads, and returns once they're all done.
+ * Jobs may run in any order, so they must only write to
+ * their own results.
+ * @param job Function to run.
+ * @param data Data passed to every job.
+ * @param count Number of jobs.
+ */
+void ThreadPool::run(Job job, void *data, int count)
+{
+	if (_threads.empty() || count < 2)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			job(data, i);
+		}
+		return;
+	}
+	SDL_LockMutex(_mutex);
+	_job = job;
+	_data = data;
+	_next = 0;
+	_count = count;
+	SDL_CondBroadcast(_wake);
+	runJobs();
+	while (_next < _count || _running > 0)
+	{
+		SDL_CondWait(_done, _mutex);
+	}
+	_job = 0;
+	_data = 0;
+	_count = 0;
+	_next = 0;
+	SDL_UnlockMutex(_mutex);
+}
+
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_THREADPOOL_H
+#define OPENXCOM_THREADPOOL_H
+
+#include <vector>
+#include <SDL.h>
+#include <SDL_thread.h>
+
+namespace OpenXcom
+{
+
+/**
+ * A fixed set of worker threads that share the work of a loop.
+ * Jobs are numbered, each one is run exactly once, and the caller
+ * helps out and waits until all of them are done, so results can
+ * be written to per-job slots and read back in order afterwards.
+ * Only the main thread may hand out work.
+ */
+class ThreadPool
+{
+public:
+	typedef void (*Job)(void *data, int index);
+private:
+	std::vector<SDL_Thread*> _threads;
+	SDL_mutex *_mutex;
+	SDL_cond *_wake, *_done;
+	Job _job;
+	void *_data;
+	int _next, _count, _running;
+	bool _quit;
+	/// Entry point of the worker threads.
+	static int worker(void *pool);
+	/// Runs pending jobs until there are none left.
+	void runJobs();
+public:
+	/// Creates a pool with this many threads (including the caller).
+	ThreadPool(int threads);
+	/// Stops all the worker threads.
+	~ThreadPool();
+	/// Gets the number of threads sharing the work.
+	int getThreadCount() const;
+	/// Runs a job for every index and waits for them all.
+	void run(Job job, void *data, int count);
+};
+
+}
+
+#endif
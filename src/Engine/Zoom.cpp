@@ -18,6 +18,8 @@
  */
 
 #include "Zoom.h"
+#include <algorithm>
+#include <cstring>
 
 //#include "Scalers/hq2x.hpp"
 
@@ -26,6 +28,7 @@
 #include "Logger.h"
 #include "Options.h"
 #include "Screen.h"
+#include "ThreadPool.h"
 
 #include "OpenGL.h"
 
@@ -596,8 +599,11 @@ bool Zoom::haveSSE2()
 /**
  * Wrapper around various software and OpenGL screen buffer pushing functions which zoom.
  * Basically called just from Screen::flip()
+ * @param pool Threads to share the scaling between, if any.
+ * @param firstRow First source row that changed.
+ * @param lastRow Source row after the last one that changed. Only used without black bands.
  */
-void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand, OpenGL *glOut)
+void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand, OpenGL *glOut, ThreadPool *pool, int firstRow, int lastRow)
 {
 	if (Screen::isOpenGLEnabled())
 	{
@@ -613,7 +619,7 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 	}
 	else if (topBlackBand <= 0 && bottomBlackBand <= 0 && leftBlackBand <= 0 && rightBlackBand <= 0)
 	{
-		_zoomSurfaceY(src, dst, 0, 0);
+		_zoomSurfaceY(src, dst, 0, 0, pool, firstRow, lastRow);
 	}
 	else if (dst->w - leftBlackBand - rightBlackBand == src->w && dst->h - topBlackBand - bottomBlackBand == src->h)
 	{
@@ -623,7 +629,7 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 	else
 	{
 		SDL_Surface *tmp = SDL_CreateRGBSurface(dst->flags, dst->w - leftBlackBand - rightBlackBand, dst->h - topBlackBand - bottomBlackBand, dst->format->BitsPerPixel, 0, 0, 0, 0);
-		_zoomSurfaceY(src, tmp, 0, 0);
+		_zoomSurfaceY(src, tmp, 0, 0, pool);
 		if (src->format->palette != NULL)
 		{
 			SDL_SetPalette(tmp, SDL_LOGPAL|SDL_PHYSPAL, src->format->palette->colors, 0, src->format->palette->ncolors);
@@ -635,6 +641,104 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 }
 
 
+namespace
+{
+
+/// The ways a frame can be scaled in bands.
+enum ZoomMethod { ZOOM_HQ2X, ZOOM_HQ3X, ZOOM_HQ4X, ZOOM_SCALE, ZOOM_NEAREST };
+
+/// A frame being scaled in horizontal bands.
+struct ZoomJob
+{
+	ZoomMethod method;
+	SDL_Surface *src, *dst;
+	int factor, bands;
+	int begin, end;
+	const Uint8 *origin;
+	const int *columns, *rows;
+};
+
+/**
+ * Scales one horizontal band of a frame. The scaling filters
+ * split the source rows between the bands, the plain zoomer
+ * splits the destination rows. Either way, only the rows from
+ * job->begin to job->end are split.
+ * @param data Pointer to the ZoomJob.
+ * @param index Band number.
+ */
+void zoomBand(void *data, int index)
+{
+	const ZoomJob *job = (const ZoomJob*)data;
+	SDL_Surface *src = job->src, *dst = job->dst;
+	const int height = job->end - job->begin;
+	const int begin = job->begin + height * index / job->bands, end = job->begin + height * (index + 1) / job->bands;
+
+	switch (job->method)
+	{
+	case ZOOM_HQ2X:
+		hq2x_32_rb_rows((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h, begin, end);
+		break;
+	case ZOOM_HQ3X:
+		hq3x_32_rb_rows((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h, begin, end);
+		break;
+	case ZOOM_HQ4X:
+		hq4x_32_rb_rows((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h, begin, end);
+		break;
+	case ZOOM_SCALE:
+		scale_rows(job->factor, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h, begin, end);
+		break;
+	case ZOOM_NEAREST:
+		for (int y = begin; y < end; ++y)
+		{
+			Uint8 *dp = (Uint8 *) dst->pixels + y * dst->pitch;
+			if (y > begin && job->rows[y] == job->rows[y - 1])
+			{
+				// same source row as the last one, just copy it
+				memcpy(dp, dp - dst->pitch, dst->w);
+				continue;
+			}
+			const Uint8 *sp = job->origin + job->rows[y];
+			const int *csax = job->columns;
+			for (int x = 0; x < dst->w; ++x)
+			{
+				*dp = *sp;
+				sp += *csax;
+				csax++;
+				dp++;
+			}
+		}
+		break;
+	}
+}
+
+/**
+ * Scales a frame, sharing the bands out between
+ * the threads in the pool if there is one.
+ * @param job Frame to scale.
+ * @param pool Thread pool, or 0 to do it all here.
+ */
+void zoomBands(ZoomJob *job, ThreadPool *pool)
+{
+	// a couple of bands per thread keeps them all busy,
+	// but each band should still have a decent amount of rows
+	const int rows = job->end - job->begin;
+	if (rows <= 0)
+	{
+		return;
+	}
+	job->bands = pool ? std::min(pool->getThreadCount() * 2, std::max(rows / 16, 1)) : 1;
+	if (job->bands > 1)
+	{
+		pool->run(zoomBand, job, job->bands);
+	}
+	else
+	{
+		zoomBand(job, 0);
+	}
+}
+
+}
+
 /**
  * Internal 8 bit Zoomer without smoothing.
  * Source code originally from SDL_gfx (LGPL) with permission by author.
@@ -642,22 +746,33 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
  * Zooms 8bit palette/Y 'src' surface to 'dst' surface.
  * Assumes src and dst surfaces are of 8 bit depth.
  * Assumes dst surface was allocated with the correct dimensions.
+ * The work is split in horizontal bands that run on the thread pool.
  *
  * @param src The surface to zoom (input).
  * @param dst The zoomed surface (output).
  * @param flipx Flag indicating if the image should be horizontally flipped.
  * @param flipy Flag indicating if the image should be vertically flipped.
+ * @param pool Threads to share the scaling between, if any.
+ * @param firstRow First source row that changed.
+ * @param lastRow Source row after the last one that changed.
  * @return 0 for success or -1 for error.
  */
-int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy)
+int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, ThreadPool *pool, int firstRow, int lastRow)
 {
 	int x, y;
-	static Uint32 *sax, *say;
-	Uint32 *csax, *csay;
-	int csx, csy;
-	Uint8 *sp, *dp, *csp;
-	int dgap;
+	static int *sax, *say;
+	int *csax, *csay;
+	int csx, csy, row;
+	Uint8 *csp;
 	static bool proclaimed = false;
+	ZoomJob job;
+	job.src = src;
+	job.dst = dst;
+	job.factor = 1;
+	// filters also change the output around a changed row: one row
+	// for hqx and Scale2x/3x, two for Scale4x which chains two 2x passes
+	job.begin = std::max(firstRow - FILTER_MARGIN, 0);
+	job.end = std::min(lastRow, src->h - FILTER_MARGIN) + FILTER_MARGIN;
 
 	if (Options::useHQXFilter)
 	{
@@ -673,19 +788,22 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 
 		if (dst->w == src->w * 2 && dst->h == src->h * 2)
 		{
-			hq2x_32_rb((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h);
+			job.method = ZOOM_HQ2X;
+			zoomBands(&job, pool);
 			return 0;
 		}
 
 		if (dst->w == src->w * 3 && dst->h == src->h * 3)
 		{
-			hq3x_32_rb((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h);
+			job.method = ZOOM_HQ3X;
+			zoomBands(&job, pool);
 			return 0;
 		}
 
 		if (dst->w == src->w * 4 && dst->h == src->h * 4)
 		{
-			hq4x_32_rb((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h);
+			job.method = ZOOM_HQ4X;
+			zoomBands(&job, pool);
 			return 0;
 		}
 
@@ -694,25 +812,16 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 	if (Options::useScaleFilter)
 	{
 		// check the resolution to see which of scale2x, scale3x, etc. we need
-
-		if (dst->w == src->w * 2 && dst->h == src->h *2 && !scale_precondition(2, src->format->BytesPerPixel, src->w, src->h))
+		for (int factor = 2; factor <= 4; ++factor)
 		{
-			scale(2, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h);
-			return 0;
-		}
-
-		if (dst->w == src->w * 3 && dst->h == src->h *3 && !scale_precondition(3, src->format->BytesPerPixel, src->w, src->h))
-		{
-			scale(3, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h);
-			return 0;
-		}
-
-		if (dst->w == src->w * 4 && dst->h == src->h *4 && !scale_precondition(4, src->format->BytesPerPixel, src->w, src->h))
-		{
-			scale(4, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h);
-			return 0;
+			if (dst->w == src->w * factor && dst->h == src->h * factor && !scale_precondition(factor, src->format->BytesPerPixel, src->w, src->h))
+			{
+				job.method = ZOOM_SCALE;
+				job.factor = factor;
+				zoomBands(&job, pool);
+				return 0;
+			}
 		}
-
 	}
 
 	// if we're scaling by a factor of 2 or 4, try to use a more efficient function	
@@ -772,28 +881,25 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 	/*
 	* Allocate memory for row increments
 	*/
-	if ((sax = (Uint32 *) realloc(sax, (dst->w + 1) * sizeof(Uint32))) == NULL) {
+	if ((sax = (int *) realloc(sax, (dst->w + 1) * sizeof(int))) == NULL) {
 		sax = 0;
 		return (-1);
 	}
-	if ((say = (Uint32 *) realloc(say, (dst->h + 1) * sizeof(Uint32))) == NULL) {
+	if ((say = (int *) realloc(say, (dst->h + 1) * sizeof(int))) == NULL) {
 		say = 0;
-		//free(sax);
 		return (-1);
 	}
 
 	/*
 	* Pointer setup
 	*/
-	sp = csp = (Uint8 *) src->pixels;
-	dp = (Uint8 *) dst->pixels;
-	dgap = dst->pitch - dst->w;
+	csp = (Uint8 *) src->pixels;
 
 	if (flipx) csp += (src->w-1);
 	if (flipy) csp  = ( (Uint8*)csp + src->pitch*(src->h-1) );
 
 	/*
-	* Precalculate row increments
+	* Precalculate column increments and row offsets
 	*/
 	csx = 0;
 	csax = sax;
@@ -808,50 +914,32 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 		csax++;
 	}
 	csy = 0;
+	row = 0;
 	csay = say;
+	job.begin = dst->h;
+	job.end = 0;
 	for (y = 0; y < dst->h; y++) {
+		if (row >= firstRow && row < lastRow) {
+			job.begin = std::min(job.begin, y);
+			job.end = y + 1;
+		}
+		*csay = row * src->pitch * (flipy ? -1 : 1);
 		csy += src->h;
-		*csay = 0;
 		while (csy >= dst->h) {
 			csy -= dst->h;
-			(*csay)++;
+			row++;
 		}
-		(*csay) *= src->pitch * (flipy ? -1 : 1);
 		csay++;
 	}
+
 	/*
 	* Draw
 	*/
-	csay = say;
-	for (y = 0; y < dst->h; y++) {
-		csax = sax;
-		sp = csp;
-		for (x = 0; x < dst->w; x++) {
-			/*
-			* Draw
-			*/
-			*dp = *sp;
-			/*
-			* Advance source pointers
-			*/
-			sp += (*csax);
-			csax++;
-			/*
-			* Advance destination pointer
-			*/
-			dp++;
-		}
-		/*
-		* Advance source pointer (for row)
-		*/
-		csp += (*csay);
-		csay++;
-
-		/*
-		* Advance destination pointers
-		*/
-		dp += dgap;
-	}
+	job.method = ZOOM_NEAREST;
+	job.origin = csp;
+	job.columns = sax;
+	job.rows = say;
+	zoomBands(&job, pool);
 
 	/*
 	* Never remove temp arrays
@@ -862,6 +950,5 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 	return 0;
 }
 
-
 }
 
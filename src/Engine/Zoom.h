@@ -19,21 +19,25 @@
 #ifndef ZOOM_H
 #define ZOOM_H
 
+#include <climits>
 #include <SDL.h>
 #include "OpenGL.h"
 
 namespace OpenXcom
 {
 
+class ThreadPool;
 
 class Zoom
 {
 
 	public:
+	/// Source rows around a change whose scaled output can differ.
+	static const int FILTER_MARGIN = 2;
 	/// Flip screen given src and dst; might use software or OpenGL.
-	static void flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand, OpenGL *glOut);
+	static void flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand, OpenGL *glOut, ThreadPool *pool = 0, int firstRow = 0, int lastRow = INT_MAX);
 	/// Copy src to dst, resizing as needed. Please don't use flipx or flipy as the optimized functions ignore these parameters.
-	static int _zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy);
+	static int _zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, ThreadPool *pool = 0, int firstRow = 0, int lastRow = INT_MAX);
 	/// Check for SSE2 instructions using CPUID.
 	static bool haveSSE2();
 
@@ -1045,21 +1045,13 @@ void DogfightState::move()
 		{
 			if(_ufo->getShotDownByCraftId() == _craft->getId())
 			{
-				for(std::vector<Country*>::iterator country = _game->getSavedGame()->getCountries()->begin(); country != _game->getSavedGame()->getCountries()->end(); ++country)
+				if (Country *country = _game->getSavedGame()->locateCountry(_game->getRuleset(), _ufo->getLongitude(), _ufo->getLatitude()))
 				{
-					if((*country)->getRules()->insideCountry(_ufo->getLongitude(), _ufo->getLatitude()))
-					{
-						(*country)->addActivityXcom(_ufo->getRules()->getScore()*2);
-						break;
-					}
+					country->addActivityXcom(_ufo->getRules()->getScore()*2);
 				}
-				for(std::vector<Region*>::iterator region = _game->getSavedGame()->getRegions()->begin(); region != _game->getSavedGame()->getRegions()->end(); ++region)
+				if (Region *region = _game->getSavedGame()->locateRegion(_game->getRuleset(), _ufo->getLongitude(), _ufo->getLatitude()))
 				{
-					if((*region)->getRules()->insideRegion(_ufo->getLongitude(), _ufo->getLatitude()))
-					{
-						(*region)->addActivityXcom(_ufo->getRules()->getScore()*2);
-						break;
-					}
+					region->addActivityXcom(_ufo->getRules()->getScore()*2);
 				}
 				setStatus("STR_UFO_DESTROYED");
 				_game->getResourcePack()->getSound("GEO.CAT", 10)->play(); //11
@@ -1072,21 +1064,13 @@ void DogfightState::move()
 			{
 				setStatus("STR_UFO_CRASH_LANDS");
 				_game->getResourcePack()->getSound("GEO.CAT", 10)->play(); //10
-				for(std::vector<Country*>::iterator country = _game->getSavedGame()->getCountries()->begin(); country != _game->getSavedGame()->getCountries()->end(); ++country)
+				if (Country *country = _game->getSavedGame()->locateCountry(_game->getRuleset(), _ufo->getLongitude(), _ufo->getLatitude()))
 				{
-					if((*country)->getRules()->insideCountry(_ufo->getLongitude(), _ufo->getLatitude()))
-					{
-						(*country)->addActivityXcom(_ufo->getRules()->getScore());
-						break;
-					}
+					country->addActivityXcom(_ufo->getRules()->getScore());
 				}
-				for(std::vector<Region*>::iterator region = _game->getSavedGame()->getRegions()->begin(); region != _game->getSavedGame()->getRegions()->end(); ++region)
+				if (Region *region = _game->getSavedGame()->locateRegion(_game->getRuleset(), _ufo->getLongitude(), _ufo->getLatitude()))
 				{
-					if((*region)->getRules()->insideRegion(_ufo->getLongitude(), _ufo->getLatitude()))
-					{
-						(*region)->addActivityXcom(_ufo->getRules()->getScore());
-						break;
-					}
+					region->addActivityXcom(_ufo->getRules()->getScore());
 				}
 			}
 			if (!_globe->insideLand(_ufo->getLongitude(), _ufo->getLatitude()))
@@ -23,6 +23,7 @@
 #include <iomanip>
 #include <ctime>
 #include <algorithm>
+#include <climits>
 #include <functional>
 #include <assert.h>
 #include "../Engine/RNG.h"
@@ -43,6 +44,7 @@
 #include "../Savegame/GameTime.h"
 #include "../Engine/Music.h"
 #include "../Savegame/SavedGame.h"
+#include "../Savegame/SaveWriter.h"
 #include "../Ruleset/Ruleset.h"
 #include "../Savegame/Base.h"
 #include "../Savegame/BaseFacility.h"
@@ -164,6 +166,7 @@ GeoscapeState::GeoscapeState(Game *game) : State(game), _pause(false), _zoomInEf
 	_dogfightStartTimer = new Timer(50);
 
 	_txtDebug = new Text(200, 18, 0, 0);
+	_txtSaving = new Text(200, 9, 0, 18);
 
 	// Set palette
 	setPalette("PAL_GEOSCAPE");
@@ -208,6 +211,7 @@ GeoscapeState::GeoscapeState(Game *game) : State(game), _pause(false), _zoomInEf
 	add(_txtYear);
 
 	add(_txtDebug);
+	add(_txtSaving);
 
 	// Set up objects
 	_game->getResourcePack()->getSurface("GEOBORD.SCR")->blit(_bg);
@@ -364,6 +368,10 @@ GeoscapeState::GeoscapeState(Game *game) : State(game), _pause(false), _zoomInEf
 	_txtYear->setAlign(ALIGN_CENTER);
 
 	_txtDebug->setColor(Palette::blockOffset(15)+4);
+
+	_txtSaving->setColor(Palette::blockOffset(15)+4);
+	_txtSaving->setText(tr("STR_SAVING_GAME"));
+	_txtSaving->setVisible(false);
 	
 	if (Options::showFundsOnGeoscape)
 	{
@@ -519,6 +527,16 @@ void GeoscapeState::think()
 	_zoomOutEffectTimer->think(this, 0);
 	_dogfightStartTimer->think(this, 0);
 
+	// Show background saves in progress and report the ones that couldn't be written
+	_txtSaving->setVisible(_game->getSaveWriter()->isBusy());
+	std::string error;
+	if (_game->getSaveWriter()->getError(&error))
+	{
+		std::wostringstream msg;
+		msg << tr("STR_SAVE_UNSUCCESSFUL") << L'\x02' << Language::fsToWstr(error);
+		popup(new ErrorMessageState(_game, msg.str(), _palette, Palette::blockOffset(8) + 10, "BACK01.SCR", 6));
+	}
+
 	if (_game->getSavedGame()->getMonthsPassed() == -1)
 	{
 		_game->getSavedGame()->addMonth();
@@ -621,10 +639,20 @@ void GeoscapeState::timeAdvance()
 		timeSpan = 12 * 5 * 6 * 2 * 24;
 	}
 
+	// steps where time5Seconds() would do nothing are skipped
+	// and caught up on in one go, so quiet stretches go by fast
+	int idle = 0, skipped = 0;
 	for (int i = 0; i < timeSpan && !_pause; ++i)
 	{
 		TimeTrigger trigger;
 		trigger = _game->getSavedGame()->getTime()->advance();
+		if (trigger == TIME_5SEC && skipped < idle)
+		{
+			++skipped;
+			continue;
+		}
+		skipSteps(skipped);
+		skipped = 0;
 		switch (trigger)
 		{
 		case TIME_1MONTH:
@@ -640,7 +668,9 @@ void GeoscapeState::timeAdvance()
 		case TIME_5SEC:
 			time5Seconds();
 		}
+		idle = getIdleSteps();
 	}
+	skipSteps(skipped);
 
 	_pause = !_dogfightsToBeStarted.empty();
 
@@ -744,21 +774,13 @@ void GeoscapeState::time5Seconds()
 		{
 			if ((*j)->isDestroyed())
 			{
-				for(std::vector<Country*>::iterator country = _game->getSavedGame()->getCountries()->begin(); country != _game->getSavedGame()->getCountries()->end(); ++country)
+				if (Country *country = _game->getSavedGame()->locateCountry(_game->getRuleset(), (*j)->getLongitude(), (*j)->getLatitude()))
 				{
-					if((*country)->getRules()->insideCountry((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						(*country)->addActivityXcom(-(*j)->getRules()->getScore());
-						break;
-					}
+					country->addActivityXcom(-(*j)->getRules()->getScore());
 				}
-				for(std::vector<Region*>::iterator region = _game->getSavedGame()->getRegions()->begin(); region != _game->getSavedGame()->getRegions()->end(); ++region)
+				if (Region *region = _game->getSavedGame()->locateRegion(_game->getRuleset(), (*j)->getLongitude(), (*j)->getLatitude()))
 				{
-					if((*region)->getRules()->insideRegion((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						(*region)->addActivityXcom(-(*j)->getRules()->getScore());
-						break;
-					}
+					region->addActivityXcom(-(*j)->getRules()->getScore());
 				}
 				// if a transport craft has been shot down, kill all the soldiers on board.
 				if ((*j)->getRules()->getSoldiers() > 0)
@@ -951,6 +973,80 @@ void GeoscapeState::time5Seconds()
 	}
 }
 
+/**
+ * Works out how many of the coming 5 second steps time5Seconds()
+ * can skip, because nothing is moving and no countdown runs out:
+ * no UFOs flying, no craft heading anywhere, no waypoints to clean up.
+ * @return Number of steps that can be skipped.
+ */
+int GeoscapeState::getIdleSteps() const
+{
+	SavedGame *save = _game->getSavedGame();
+	if (save->getBases()->empty())
+	{
+		return 0;
+	}
+	int idle = INT_MAX;
+	for (std::vector<Ufo*>::const_iterator i = save->getUfos()->begin(); i != save->getUfos()->end(); ++i)
+	{
+		switch ((*i)->getStatus())
+		{
+		case Ufo::LANDED:
+			// the step where it runs out has to be handled
+			idle = std::min(idle, (*i)->getSecondsRemaining() / 5 - 1);
+			break;
+		case Ufo::CRASHED:
+			// crash sites only count down every 30 minutes
+			if (!(*i)->getDetected() || (*i)->getSecondsRemaining() == 0)
+			{
+				return 0;
+			}
+			break;
+		default:
+			return 0;
+		}
+	}
+	for (std::vector<Base*>::const_iterator i = save->getBases()->begin(); i != save->getBases()->end(); ++i)
+	{
+		for (std::vector<Craft*>::const_iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
+		{
+			if ((*j)->isDestroyed() || (*j)->getDestination() != 0)
+			{
+				return 0;
+			}
+		}
+	}
+	for (std::vector<Waypoint*>::const_iterator i = save->getWaypoints()->begin(); i != save->getWaypoints()->end(); ++i)
+	{
+		if ((*i)->getFollowers()->empty())
+		{
+			return 0;
+		}
+	}
+	return std::max(idle, 0);
+}
+
+/**
+ * Applies everything time5Seconds() would have done
+ * over the skipped steps, which is just landed UFOs
+ * counting down to takeoff.
+ * @param steps Number of steps skipped.
+ */
+void GeoscapeState::skipSteps(int steps)
+{
+	if (steps == 0)
+	{
+		return;
+	}
+	for (std::vector<Ufo*>::iterator i = _game->getSavedGame()->getUfos()->begin(); i != _game->getSavedGame()->getUfos()->end(); ++i)
+	{
+		if ((*i)->getStatus() == Ufo::LANDED)
+		{
+			(*i)->setSecondsRemaining((*i)->getSecondsRemaining() - steps * 5);
+		}
+	}
+}
+
 /**
  * Functor that attempt to detect an XCOM base.
  */
@@ -1105,13 +1201,9 @@ bool GeoscapeState::processTerrorSite(TerrorSite *ts) const
 		region->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_TERROR")->getPoints() * 100);
 		//kids, tell your folks... don't ignore terror sites.
 	}
-	for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+	if (Country *country = _game->getSavedGame()->locateCountry(_game->getRuleset(), ts->getLongitude(), ts->getLatitude()))
 	{
-		if ((*k)->getRules()->insideCountry(ts->getLongitude(), ts->getLatitude()))
-		{
-			(*k)->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_TERROR")->getPoints() * 100);
-			break;
-		}
+		country->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_TERROR")->getPoints() * 100);
 	}
 	delete ts;
 	return true;
@@ -1206,6 +1298,19 @@ void GeoscapeState::time30Minutes()
 		}
 	}
 
+	// Gather the craft radars once for the whole detection pass
+	std::vector<Craft*> radars;
+	for (std::vector<Base*>::iterator b = _game->getSavedGame()->getBases()->begin(); b != _game->getSavedGame()->getBases()->end(); ++b)
+	{
+		for (std::vector<Craft*>::iterator c = (*b)->getCrafts()->begin(); c != (*b)->getCrafts()->end(); ++c)
+		{
+			if ((*c)->getStatus() == "STR_OUT" && (*c)->getRules()->getRadarRange() > 0)
+			{
+				radars.push_back(*c);
+			}
+		}
+	}
+
 	// Handle UFO detection and give aliens points
 	for (std::vector<Ufo*>::iterator u = _game->getSavedGame()->getUfos()->begin(); u != _game->getSavedGame()->getUfos()->end(); ++u)
 	{
@@ -1217,24 +1322,16 @@ void GeoscapeState::time30Minutes()
 		case Ufo::FLYING:
 			points++;
 			// Get area
-			for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
+			if (Region *region = _game->getSavedGame()->locateRegion(_game->getRuleset(), (*u)->getLongitude(), (*u)->getLatitude()))
 			{
-				if ((*k)->getRules()->insideRegion((*u)->getLongitude(), (*u)->getLatitude()))
-				{
-					//one point per UFO in-flight per half hour
-					(*k)->addActivityAlien(points);
-					break;
-				}
+				//one point per UFO in-flight per half hour
+				region->addActivityAlien(points);
 			}
 			// Get country
-			for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+			if (Country *country = _game->getSavedGame()->locateCountry(_game->getRuleset(), (*u)->getLongitude(), (*u)->getLatitude()))
 			{
-				if ((*k)->getRules()->insideCountry((*u)->getLongitude(), (*u)->getLatitude()))
-				{
-					//one point per UFO in-flight per half hour
-					(*k)->addActivityAlien(points);
-					break;
-				}
+				//one point per UFO in-flight per half hour
+				country->addActivityAlien(points);
 			}
 			if (!(*u)->getDetected())
 			{
@@ -1249,14 +1346,10 @@ void GeoscapeState::time30Minutes()
 					case 1: // conventional radar
 						detected = true;
 					}
-					for (std::vector<Craft*>::iterator c = (*b)->getCrafts()->begin(); !detected && c != (*b)->getCrafts()->end(); ++c)
-					{
-						if ((*c)->getStatus() == "STR_OUT" && (*c)->detect(*u))
-						{
-							detected = true;
-							break;
-						}
-					}
+				}
+				for (std::vector<Craft*>::iterator c = radars.begin(); !detected && c != radars.end(); ++c)
+				{
+					detected = (*c)->detect(*u);
 				}
 				if (detected)
 				{
@@ -1280,15 +1373,10 @@ void GeoscapeState::time30Minutes()
 						detected = true;
 						hyperdetected = (*u)->getHyperDetected();
 					}
-					for (std::vector<Craft*>::iterator c = (*b)->getCrafts()->begin(); !detected && c != (*b)->getCrafts()->end(); ++c)
-					{
-						if ((*c)->getStatus() == "STR_OUT" && (*c)->detect(*u))
-						{
-							detected = true;
-							hyperdetected = (*u)->getHyperDetected();
-							break;
-						}
-					}
+				}
+				for (std::vector<Craft*>::iterator c = radars.begin(); !detected && c != radars.end(); ++c)
+				{
+					detected = (*c)->detect(*u);
 				}
 				if (!detected)
 				{
@@ -1448,6 +1536,7 @@ void GeoscapeState::time1Day()
 				(*j)->build();
 				if ((*j)->getBuildTime() == 0)
 				{
+					(*i)->invalidateRadar();
 					popup(new ProductionCompleteState(_game, (*i),  tr((*j)->getRules()->getType()), this, PROGRESS_CONSTRUCTION));
 				}
 			}
@@ -1482,15 +1571,7 @@ void GeoscapeState::time1Day()
 				std::vector<std::string> possibilities;
 				for(std::vector<std::string>::const_iterator f = (*iter)->getRules()->getGetOneFree().begin(); f != (*iter)->getRules()->getGetOneFree().end(); ++f)
 				{
-					bool newFound = true;
-					for(std::vector<const RuleResearch*>::const_iterator discovered = _game->getSavedGame()->getDiscoveredResearch().begin(); discovered != _game->getSavedGame()->getDiscoveredResearch().end(); ++discovered)
-					{
-						if(*f == (*discovered)->getName())
-						{
-							newFound = false;
-						}
-					}
-					if(newFound)
+					if(!_game->getSavedGame()->isDiscovered(_game->getRuleset()->getResearch(*f)))
 					{
 						possibilities.push_back(*f);
 					}
@@ -1581,21 +1662,13 @@ void GeoscapeState::time1Day()
 	// handle regional and country points for alien bases
 	for(std::vector<AlienBase*>::const_iterator b = _game->getSavedGame()->getAlienBases()->begin(); b != _game->getSavedGame()->getAlienBases()->end(); ++b)
 	{
-		for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
+		if (Region *region = _game->getSavedGame()->locateRegion(_game->getRuleset(), (*b)->getLongitude(), (*b)->getLatitude()))
 		{
-			if ((*k)->getRules()->insideRegion((*b)->getLongitude(), (*b)->getLatitude()))
-			{
-				(*k)->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_BASE")->getPoints() / 10);
-				break;
-			}
+			region->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_BASE")->getPoints() / 10);
 		}
-		for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+		if (Country *country = _game->getSavedGame()->locateCountry(_game->getRuleset(), (*b)->getLongitude(), (*b)->getLatitude()))
 		{
-			if ((*k)->getRules()->insideCountry((*b)->getLongitude(), (*b)->getLatitude()))
-			{
-				(*k)->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_BASE")->getPoints() / 10);
-				break;
-			}
+			country->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_BASE")->getPoints() / 10);
 		}
 	}
 
@@ -1648,23 +1721,19 @@ void GeoscapeState::time1Month()
 	{
 		if (newRetaliation)
 		{
-			for (std::vector<Region*>::iterator i = _game->getSavedGame()->getRegions()->begin(); i != _game->getSavedGame()->getRegions()->end(); ++i)
+			if (Region *region = _game->getSavedGame()->locateRegion(_game->getRuleset(), (*b)->getLongitude(), (*b)->getLatitude()))
 			{
-				if ((*i)->getRules()->insideRegion((*b)->getLongitude(), (*b)->getLatitude()))
+				if (!_game->getSavedGame()->getAlienMission(region->getRules()->getType(), "STR_ALIEN_RETALIATION"))
 				{
-					if (!_game->getSavedGame()->getAlienMission((*i)->getRules()->getType(), "STR_ALIEN_RETALIATION"))
-					{
-						const RuleAlienMission &rule = *_game->getRuleset()->getAlienMission("STR_ALIEN_RETALIATION");
-						AlienMission *mission = new AlienMission(rule);
-						mission->setId(_game->getSavedGame()->getId("ALIEN_MISSIONS"));
-						mission->setRegion((*i)->getRules()->getType(), *_game->getRuleset());
-						int race = RNG::generate(0, _game->getRuleset()->getAlienRacesList().size()-2); // -2 to avoid "MIXED" race
-						mission->setRace(_game->getRuleset()->getAlienRacesList().at(race));
-						mission->start(150);
-						_game->getSavedGame()->getAlienMissions().push_back(mission);
-						newRetaliation = false;
-					}
-					break;
+					const RuleAlienMission &rule = *_game->getRuleset()->getAlienMission("STR_ALIEN_RETALIATION");
+					AlienMission *mission = new AlienMission(rule);
+					mission->setId(_game->getSavedGame()->getId("ALIEN_MISSIONS"));
+					mission->setRegion(region->getRules()->getType(), *_game->getRuleset());
+					int race = RNG::generate(0, _game->getRuleset()->getAlienRacesList().size()-2); // -2 to avoid "MIXED" race
+					mission->setRace(_game->getRuleset()->getAlienRacesList().at(race));
+					mission->start(150);
+					_game->getSavedGame()->getAlienMissions().push_back(mission);
+					newRetaliation = false;
 				}
 			}
 		}
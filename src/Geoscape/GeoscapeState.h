@@ -52,7 +52,7 @@ private:
 	Text *_txtFunds, *_txtHour, *_txtHourSep, *_txtMin, *_txtMinSep, *_txtSec, *_txtWeekday, *_txtDay, *_txtMonth, *_txtYear;
 	Timer *_timer, *_zoomInEffectTimer, *_zoomOutEffectTimer, *_dogfightStartTimer;
 	bool _pause, _zoomInEffectDone, _zoomOutEffectDone;
-	Text *_txtDebug;
+	Text *_txtDebug, *_txtSaving;
 	std::list<State*> _popups;
 	std::list<DogfightState*> _dogfights, _dogfightsToBeStarted;
 	size_t _minimizedDogfights;
@@ -73,6 +73,10 @@ public:
 	void timeAdvance();
 	/// Trigger whenever 5 seconds pass.
 	void time5Seconds();
+	/// Gets how many 5 second steps will pass with nothing happening.
+	int getIdleSteps() const;
+	/// Catches up on the 5 second steps that were skipped.
+	void skipSteps(int steps);
 	/// Trigger whenever 10 minutes pass.
 	void time10Minutes();
 	/// Trigger whenever 30 minutes pass.
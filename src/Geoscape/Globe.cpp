@@ -20,6 +20,7 @@
 #include "Globe.h"
 #include <cmath>
 #include <fstream>
+#include <algorithm>
 #include "../aresame.h"
 #include "../Engine/Action.h"
 #include "../Engine/SurfaceSet.h"
@@ -170,7 +171,14 @@ struct Ocean
 
 struct CreateShadow
 {
-	static inline Uint8 getShadowValue(const Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise)
+	/**
+	 * Calculates how much sunlight reaches a point on the globe.
+	 * @param earth Normal of the globe surface.
+	 * @param sun Direction of the sun.
+	 * @param noise Dithering noise.
+	 * @return Shade level 1-31, or 0 if the point is lit.
+	 */
+	static inline Sint16 getShadowTerm(const Cord& earth, const Cord& sun, const Sint16& noise)
 	{
 		Cord temp = earth;
 		//diff
@@ -195,9 +203,21 @@ struct CreateShadow
 		temp.x -= noise;
 
 		if(temp.x > 0.)
+			return (temp.x> 31)? 31 : (Sint16)temp.x;
+		return 0;
+	}
+
+	/**
+	 * Darkens a globe pixel by a shade level.
+	 * @param dest Color of the pixel.
+	 * @param val Shade level from getShadowTerm.
+	 * @return Shaded color.
+	 */
+	static inline Uint8 applyShadow(const Uint8& dest, const Sint16& val)
+	{
+		const int d = dest & helper::ColorGroup;
+		if(val > 0)
 		{
-			const Sint16 val = (temp.x> 31)? 31 : (Sint16)temp.x;
-			const int d = dest & helper::ColorGroup;
 			if(d ==  Palette::blockOffset(12) || d ==  Palette::blockOffset(13))
 			{
 				//this pixel is ocean
@@ -216,7 +236,6 @@ struct CreateShadow
 		}
 		else
 		{
-			const int d = dest & helper::ColorGroup;
 			if(d ==  Palette::blockOffset(12) || d ==  Palette::blockOffset(13))
 			{
 				//this pixel is ocean
@@ -229,11 +248,27 @@ struct CreateShadow
 			}
 		}
 	}
-	
-	static inline void func(Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise, const int&)
+
+	static inline Uint8 getShadowValue(const Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise)
+	{
+		return applyShadow(dest, getShadowTerm(earth, sun, noise));
+	}
+
+	static inline void func(Sint16& dest, const Cord& earth, const Cord& sun, const Sint16& noise, const int&)
+	{
+		if(earth.z)
+			dest = getShadowTerm(earth, sun, noise);
+		else
+			dest = 0;
+	}
+};
+
+struct ApplyShadow
+{
+	static inline void func(Uint8& dest, const Sint16& shadow, const Cord& earth, const int&, const int&)
 	{
 		if(dest && earth.z)
-			dest = getShadowValue(dest, earth, sun, noise);
+			dest = CreateShadow::applyShadow(dest, shadow);
 		else
 			dest = 0;
 	}
@@ -257,7 +292,7 @@ Globe::Globe(Game *game, int cenX, int cenY, int width, int height, int x, int y
 	_rotLon(0.0), _rotLat(0.0),
 	_hoverLon(0.0), _hoverLat(0.0),
 	_cenX(cenX), _cenY(cenY), _game(game),
-	_blink(true), _hover(false), _cacheLand()
+	_blink(true), _hover(false), _cacheLand(), _shadowZoom((size_t)-1), _shadowMoveX(0), _shadowMoveY(0)
 {
 	_texture = new SurfaceSet(*_game->getResourcePack()->getSurfaceSet("TEXTURE.DAT"));
 
@@ -400,11 +435,6 @@ Globe::~Globe()
 	delete _mkAlienSite;
 	delete _radars;
 	delete _clipper;
-
-	for (std::list<Polygon*>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
-	{
-		delete *i;
-	}
 }
 
 /**
@@ -851,52 +881,89 @@ std::vector<Target*> Globe::getTargets(int x, int y, bool craft) const
  * Takes care of pre-calculating all the polygons currently visible
  * on the globe and caching them so they only need to be recalculated
  * when the globe is actually moved.
+ * The projection works on flat per-vertex arrays that are filled
+ * in place, so rotating the globe doesn't allocate anything, and
+ * the rotation is applied through the angle-difference identities
+ * so no trigonometry is evaluated per vertex.
  */
 void Globe::cachePolygons()
 {
-	cache(_game->getResourcePack()->getPolygons(), &_cacheLand);
+	std::list<Polygon*> *polygons = _game->getResourcePack()->getPolygons();
+	if (_polySource.size() != polygons->size())
+	{
+		loadPolygons(polygons);
+	}
+
+	const double radius = _radius[_zoom];
+	const double sinCenLon = sin(_cenLon), cosCenLon = cos(_cenLon);
+	const double sinCenLat = sin(_cenLat), cosCenLat = cos(_cenLat);
+	const size_t vertices = _polySinLon.size();
+	const double *sinLon = vertices ? &_polySinLon[0] : 0;
+	const double *cosLon = vertices ? &_polyCosLon[0] : 0;
+	const double *sinLat = vertices ? &_polySinLat[0] : 0;
+	const double *cosLat = vertices ? &_polyCosLat[0] : 0;
+	Sint16 *x = vertices ? &_cacheX[0] : 0;
+	Sint16 *y = vertices ? &_cacheY[0] : 0;
+
+	// Orthographic projection, with sin/cos(lon - cenLon) expanded
+	for (size_t i = 0; i < vertices; ++i)
+	{
+		double sinDelta = sinLon[i] * cosCenLon - cosLon[i] * sinCenLon;
+		double cosDelta = cosLon[i] * cosCenLon + sinLon[i] * sinCenLon;
+		x[i] = _cenX + (Sint16)floor(radius * cosLat[i] * sinDelta);
+		y[i] = _cenY + (Sint16)floor(radius * (cosCenLat * sinLat[i] - sinCenLat * cosLat[i] * cosDelta));
+	}
+
+	// Skip polygons with every point on the back face
+	_cacheLand.clear();
+	for (size_t i = 0; i < _polySource.size(); ++i)
+	{
+		for (size_t j = _polyFirst[i]; j < _polyFirst[i + 1]; ++j)
+		{
+			double cosDelta = cosLon[j] * cosCenLon + sinLon[j] * sinCenLon;
+			if (cosCenLat * cosLat[j] * cosDelta + sinCenLat * sinLat[j] >= 0)
+			{
+				_cacheLand.push_back(i);
+				break;
+			}
+		}
+	}
 	_redraw = true;
 }
 
 /**
- * Caches a set of polygons.
+ * Splits the land polygons into per-vertex arrays with
+ * their coordinates' sines and cosines, which stay the
+ * same no matter how the globe is turned.
  * @param polygons Pointer to list of polygons.
- * @param cache Pointer to cache.
  */
-void Globe::cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache)
+void Globe::loadPolygons(std::list<Polygon*> *polygons)
 {
-	// Clear existing cache
-	for (std::list<Polygon*>::iterator i = cache->begin(); i != cache->end(); ++i)
-	{
-		delete *i;
-	}
-	cache->clear();
+	_polySinLon.clear();
+	_polyCosLon.clear();
+	_polySinLat.clear();
+	_polyCosLat.clear();
+	_polySource.clear();
+	_polyFirst.clear();
 
-	// Pre-calculate values to cache
 	for (std::list<Polygon*>::iterator i = polygons->begin(); i != polygons->end(); ++i)
 	{
-		// Is quad on the back face?
-		bool backFace = true;
+		_polySource.push_back(*i);
+		_polyFirst.push_back(_polySinLon.size());
 		for (int j = 0; j < (*i)->getPoints(); ++j)
 		{
-			backFace = backFace && pointBack((*i)->getLongitude(j), (*i)->getLatitude(j));
-		}
-		if (backFace)
-			continue;
-
-		Polygon* p = new Polygon(**i);
-
-		// Convert coordinates
-		for (int j = 0; j < p->getPoints(); ++j)
-		{
-			Sint16 x, y;
-			polarToCart(p->getLongitude(j), p->getLatitude(j), &x, &y);
-			p->setX(j, x);
-			p->setY(j, y);
+			_polySinLon.push_back(sin((*i)->getLongitude(j)));
+			_polyCosLon.push_back(cos((*i)->getLongitude(j)));
+			_polySinLat.push_back(sin((*i)->getLatitude(j)));
+			_polyCosLat.push_back(cos((*i)->getLatitude(j)));
 		}
-
-		cache->push_back(p);
 	}
+	_polyFirst.push_back(_polySinLon.size());
+
+	_cacheX.assign(_polySinLon.size(), 0);
+	_cacheY.assign(_polySinLon.size(), 0);
+	_cacheLand.clear();
+	_cacheLand.reserve(_polySource.size());
 }
 
 /**
@@ -1009,20 +1076,14 @@ void Globe::drawOcean()
  */
 void Globe::drawLand()
 {
-	Sint16 x[4], y[4];
-
-	for (std::list<Polygon*>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
+	for (std::vector<size_t>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
 	{
-		// Convert coordinates
-		for (int j = 0; j < (*i)->getPoints(); ++j)
-		{
-			x[j] = (*i)->getX(j);
-			y[j] = (*i)->getY(j);
-		}
+		Polygon *poly = _polySource[*i];
+		size_t first = _polyFirst[*i];
 
 		// Apply textures according to zoom and shade
 		int zoom = (2 - (int)floor(_zoom / 2.0)) * NUM_TEXTURES;
-		drawTexturedPolygon(x, y, (*i)->getPoints(), _texture->getFrame((*i)->getTexture() + zoom), 0, 0);
+		drawTexturedPolygon(&_cacheX[first], &_cacheY[first], poly->getPoints(), _texture->getFrame(poly->getTexture() + zoom), 0, 0);
 	}
 }
 
@@ -1084,15 +1145,110 @@ Cord Globe::getSunDirection(double lon, double lat) const
 
 void Globe::drawShadow()
 {
+	const int moveX = _cenX - getWidth() / 2, moveY = _cenY - getHeight() / 2;
+	if (_shadowZoom != _zoom || _shadowMoveX != getX() - moveX || _shadowMoveY != getY() - moveY)
+	{
+		cacheShadowTiles();
+	}
+
 	ShaderMove<Cord> earth = ShaderMove<Cord>(_earthData[_zoom], getWidth(), getHeight());
 	ShaderRepeat<Sint16> noise = ShaderRepeat<Sint16>(_randomNoiseData, static_data.random_surf_size, static_data.random_surf_size);
-	
-	earth.setMove(_cenX-getWidth()/2, _cenY-getHeight()/2);
-	
+	ShaderMove<Sint16> shadow = ShaderMove<Sint16>(_shadowTerm, getWidth(), getHeight(), getX(), getY());
+	const Cord sun = getSunDirection(_cenLon, _cenLat);
+
+	earth.setMove(moveX, moveY);
+
+	// Only tiles touching the terminator, or that just
+	// crossed it, need their shadow recalculated.
+	const int tilesX = (getWidth() + SHADOW_TILE - 1) / SHADOW_TILE;
+	for (size_t i = 0; i < _shadowTiles.size(); ++i)
+	{
+		ShadowTile &tile = _shadowTiles[i];
+		Sint8 bucket = 0;
+		if (tile.radius >= 0.0)
+		{
+			// the dot product of any normal in the tile with the sun
+			// is within `radius` of the dot product of the tile's center
+			const double dot = tile.center.x * sun.x + tile.center.y * sun.y + tile.center.z * sun.z;
+			const double low = -250.0 * (dot + tile.radius), high = -250.0 * (dot - tile.radius);
+			if (high < -111.0)
+				bucket = 1;
+			else if (low > 121.0)
+				bucket = 2;
+			else
+				bucket = 3;
+		}
+		if (bucket == tile.bucket && bucket != 3)
+			continue;
+		tile.bucket = bucket;
+
+		const int x = (i % tilesX) * SHADOW_TILE, y = (i / tilesX) * SHADOW_TILE;
+		shadow.setDomain(GraphSubset(std::make_pair(x, x + SHADOW_TILE), std::make_pair(y, y + SHADOW_TILE)));
+		ShaderDraw<CreateShadow>(shadow, earth, ShaderScalar(sun), noise);
+	}
+	shadow.setDomain(GraphSubset(getWidth(), getHeight()));
+
 	lock();
-	ShaderDraw<CreateShadow>(ShaderSurface(this), earth, ShaderScalar(getSunDirection(_cenLon, _cenLat)), noise);
+	ShaderDraw<ApplyShadow>(ShaderSurface(this), shadow, earth);
 	unlock();
-		
+}
+
+/**
+ * Splits the globe surface into tiles and records how far
+ * the surface normals in each tile spread from their mean,
+ * so drawShadow() can tell which tiles are fully lit or fully
+ * dark without looking at their pixels.
+ */
+void Globe::cacheShadowTiles()
+{
+	const int width = getWidth(), height = getHeight();
+	const int offsetX = getX() - (_cenX - width / 2), offsetY = getY() - (_cenY - height / 2);
+	const std::vector<Cord> &earth = _earthData[_zoom];
+	const int tilesX = (width + SHADOW_TILE - 1) / SHADOW_TILE, tilesY = (height + SHADOW_TILE - 1) / SHADOW_TILE;
+
+	_shadowTerm.assign(width * height, 0);
+	_shadowTiles.assign(tilesX * tilesY, ShadowTile());
+	for (int ty = 0; ty < tilesY; ++ty)
+	{
+		for (int tx = 0; tx < tilesX; ++tx)
+		{
+			ShadowTile &tile = _shadowTiles[ty * tilesX + tx];
+			const int x0 = std::max(tx * SHADOW_TILE + offsetX, 0), x1 = std::min(std::min((tx + 1) * SHADOW_TILE, width) + offsetX, width);
+			const int y0 = std::max(ty * SHADOW_TILE + offsetY, 0), y1 = std::min(std::min((ty + 1) * SHADOW_TILE, height) + offsetY, height);
+			int count = 0;
+			for (int y = y0; y < y1; ++y)
+			{
+				for (int x = x0; x < x1; ++x)
+				{
+					if (earth[y * width + x].z)
+					{
+						tile.center += earth[y * width + x];
+						++count;
+					}
+				}
+			}
+			if (count == 0)
+				continue;
+			tile.center *= 1.0 / count;
+			for (int y = y0; y < y1; ++y)
+			{
+				for (int x = x0; x < x1; ++x)
+				{
+					if (earth[y * width + x].z)
+					{
+						Cord diff = earth[y * width + x];
+						diff -= tile.center;
+						tile.radius = std::max(tile.radius, diff.norm());
+					}
+				}
+			}
+			// leave some slack for rounding
+			tile.radius += 1e-6;
+		}
+	}
+	_shadowZoom = _zoom;
+	_shadowMoveX = offsetX;
+	_shadowMoveY = offsetY;
 }
 
 
@@ -2005,6 +2161,8 @@ void Globe::resize()
 void Globe::setupRadii(int width, int height)
 {
 	_radius.clear();
+	_shadowTiles.clear();
+	_shadowZoom = (size_t)-1;
 
 	_radius.push_back(0.45*height);
 	_radius.push_back(0.60*height);
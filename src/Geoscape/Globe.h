@@ -50,6 +50,18 @@ private:
 	static const int NEAR_RADIUS = 25;
 	static const double ROTATE_LONGITUDE;
 	static const double ROTATE_LATITUDE;
+	static const int SHADOW_TILE = 16;
+
+	///cached shadow state of a square of globe pixels
+	struct ShadowTile
+	{
+		///mean surface normal and largest distance of any normal from it, negative if the tile is off the globe
+		Cord center;
+		double radius;
+		///0 - off the globe or not drawn yet, 1 - fully lit, 2 - fully dark, 3 - crosses the terminator
+		Sint8 bucket;
+		ShadowTile() : center(), radius(-1.0), bucket(0) {}
+	};
 
 	double _cenLon, _cenLat, _rotLon, _rotLat, _hoverLon, _hoverLat;
 	Sint16 _cenX, _cenY;
@@ -59,7 +71,15 @@ private:
 	Surface *_markers, *_countries, *_radars;
 	bool _blink, _hover;
 	Timer *_blinkTimer, *_rotTimer;
-	std::list<Polygon*> _cacheLand;
+	///trigonometry of every land polygon vertex, stored as separate arrays
+	std::vector<double> _polySinLon, _polyCosLon, _polySinLat, _polyCosLat;
+	///land polygons and the index of their first vertex in the arrays
+	std::vector<Polygon*> _polySource;
+	std::vector<size_t> _polyFirst;
+	///projected screen coordinates of every land polygon vertex
+	std::vector<Sint16> _cacheX, _cacheY;
+	///land polygons currently facing the player
+	std::vector<size_t> _cacheLand;
 	Surface *_mkXcomBase, *_mkAlienBase, *_mkCraft, *_mkWaypoint, *_mkCity;
 	Surface *_mkFlyingUfo, *_mkLandedUfo, *_mkCrashedUfo, *_mkAlienSite;
 	FastLineClip *_clipper;
@@ -69,6 +89,11 @@ private:
 	std::vector<Sint16> _randomNoiseData;
 	///list of dimension of earth on screen per zoom level
 	std::vector<double> _radius;
+	///shade level of every globe pixel from the last redraw
+	std::vector<Sint16> _shadowTerm;
+	std::vector<ShadowTile> _shadowTiles;
+	size_t _shadowZoom;
+	int _shadowMoveX, _shadowMoveY;
 
 	bool _isMouseScrolling, _isMouseScrolled;
 	int _xBeforeMouseScrolling, _yBeforeMouseScrolling;
@@ -85,10 +110,12 @@ private:
 	bool insidePolygon(double lon, double lat, Polygon *poly) const;
 	/// Checks if a target is near a point.
 	bool targetNear(Target* target, int x, int y) const;
-	/// Caches a set of polygons.
-	void cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache);
+	/// Loads the polygon vertices into the projection buffers.
+	void loadPolygons(std::list<Polygon*> *polygons);
 	/// Get position of sun relative to given position in polar cords and date.
 	Cord getSunDirection(double lon, double lat) const;
+	/// Measures the surface normals of each shadow tile.
+	void cacheShadowTiles();
 	/// Draw globe range circle.
 	void drawGlobeCircle(double lat, double lon, double radius, int segments);
 	/// Special "transparent" line.
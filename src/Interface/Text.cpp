@@ -19,6 +19,7 @@
 #include "Text.h"
 #include <cctype>
 #include <cmath>
+#include <map>
 #include <sstream>
 #include "../Engine/Font.h"
 #include "../Engine/Options.h"
@@ -29,6 +30,48 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/**
+ * Everything that affects how a string is laid out,
+ * used to look up previously processed strings.
+ */
+struct TextLayoutKey
+{
+	Font *font, *small;
+	std::wstring text;
+	int width;
+	bool indent;
+	TextWrapping wrapping;
+
+	bool operator<(const TextLayoutKey &other) const
+	{
+		if (font != other.font) return font < other.font;
+		if (small != other.small) return small < other.small;
+		if (width != other.width) return width < other.width;
+		if (indent != other.indent) return indent < other.indent;
+		if (wrapping != other.wrapping) return wrapping < other.wrapping;
+		return text < other.text;
+	}
+};
+
+/**
+ * Result of processing a string: the string with any
+ * linebreaks and replaced characters, and its line metrics.
+ */
+struct TextLayout
+{
+	std::wstring text;
+	std::vector<int> lineWidth, lineHeight;
+};
+
+const size_t LAYOUT_CACHE_SIZE = 4096;
+std::map<TextLayoutKey, TextLayout> layoutCache;
+size_t layoutHits = 0, layoutMisses = 0;
+
+}
+
 /**
  * Sets up a blank text with the specified size and position.
  * @param width Width in pixels.
@@ -160,8 +203,12 @@ void Text::initText(Font *big, Font *small, Language *lang)
  */
 void Text::setText(const std::wstring &text)
 {
-	_text = text;
-	processText();
+	// Counters get set every tick, don't redraw them if nothing changed
+	if (text != _text)
+	{
+		_text = text;
+		processText();
+	}
 	// If big text won't fit the space, try small text
 	if (_font == _big && (getTextWidth() > getWidth() || getTextHeight() > getHeight()) && _text[_text.size()-1] != L'.')
 	{
@@ -202,8 +249,11 @@ void Text::setWordWrap(bool wrap, bool indent)
  */
 void Text::setInvert(bool invert)
 {
-	_invert = invert;
-	_redraw = true;
+	if (invert != _invert)
+	{
+		_invert = invert;
+		_redraw = true;
+	}
 }
 
 /**
@@ -213,8 +263,11 @@ void Text::setInvert(bool invert)
  */
 void Text::setHighContrast(bool contrast)
 {
-	_contrast = contrast;
-	_redraw = true;
+	if (contrast != _contrast)
+	{
+		_contrast = contrast;
+		_redraw = true;
+	}
 }
 
 /**
@@ -224,8 +277,11 @@ void Text::setHighContrast(bool contrast)
  */
 void Text::setAlign(TextHAlign align)
 {
-	_align = align;
-	_redraw = true;
+	if (align != _align)
+	{
+		_align = align;
+		_redraw = true;
+	}
 }
 
 /**
@@ -245,8 +301,11 @@ TextHAlign Text::getAlign() const
  */
 void Text::setVerticalAlign(TextVAlign valign)
 {
-	_valign = valign;
-	_redraw = true;
+	if (valign != _valign)
+	{
+		_valign = valign;
+		_redraw = true;
+	}
 }
 
 /**
@@ -257,9 +316,12 @@ void Text::setVerticalAlign(TextVAlign valign)
  */
 void Text::setColor(Uint8 color)
 {
-	_color = color;
-	_color2 = color;
-	_redraw = true;
+	if (color != _color || color != _color2)
+	{
+		_color = color;
+		_color2 = color;
+		_redraw = true;
+	}
 }
 
 /**
@@ -279,8 +341,11 @@ Uint8 Text::getColor() const
  */
 void Text::setSecondaryColor(Uint8 color)
 {
-	_color2 = color;
-	_redraw = true;
+	if (color != _color2)
+	{
+		_color2 = color;
+		_redraw = true;
+	}
 }
 
 /**
@@ -323,9 +388,43 @@ int Text::getTextWidth() const
 	return width;
 }
 
+/**
+ * Returns how many strings were laid out from the
+ * shared cache instead of being processed again.
+ * @return Number of cache hits.
+ */
+size_t Text::getLayoutHits()
+{
+	return layoutHits;
+}
+
+/**
+ * Returns how many strings had to be processed
+ * because they weren't in the shared cache.
+ * @return Number of cache misses.
+ */
+size_t Text::getLayoutMisses()
+{
+	return layoutMisses;
+}
+
+/**
+ * Empties the shared cache and its counters. Layouts are keyed
+ * by font, so this must be done whenever the fonts are replaced,
+ * or new fonts at reused addresses would get stale metrics.
+ */
+void Text::clearLayoutCache()
+{
+	layoutCache.clear();
+	layoutHits = 0;
+	layoutMisses = 0;
+}
+
 /**
  * Takes care of any text post-processing like calculating
  * line metrics for alignment and wordwrapping if necessary.
+ * The results are shared between all texts, so the same string
+ * in the same font and width is only measured once.
  */
 void Text::processText()
 {
@@ -339,10 +438,33 @@ void Text::processText()
 	// Use a separate string for wordwrapping text
 	if (_wrap)
 	{
-		_wrappedText = _text;
 		str = &_wrappedText;
 	}
 
+	TextLayoutKey key;
+	key.font = _font;
+	key.small = _small;
+	key.text = _text;
+	key.width = _wrap ? getWidth() : -1;
+	key.indent = _wrap && _indent;
+	key.wrapping = _wrap ? _lang->getTextWrapping() : WRAP_WORDS;
+	std::map<TextLayoutKey, TextLayout>::const_iterator cached = layoutCache.find(key);
+	if (cached != layoutCache.end())
+	{
+		*str = cached->second.text;
+		_lineWidth = cached->second.lineWidth;
+		_lineHeight = cached->second.lineHeight;
+		layoutHits++;
+		_redraw = true;
+		return;
+	}
+	layoutMisses++;
+
+	if (_wrap)
+	{
+		_wrappedText = _text;
+	}
+
 	_lineWidth.clear();
 	_lineHeight.clear();
 
@@ -435,6 +557,15 @@ void Text::processText()
 		}
 	}
 
+	if (layoutCache.size() >= LAYOUT_CACHE_SIZE)
+	{
+		layoutCache.clear();
+	}
+	TextLayout &layout = layoutCache[key];
+	layout.text = *str;
+	layout.lineWidth = _lineWidth;
+	layout.lineHeight = _lineHeight;
+
 	_redraw = true;
 }
 
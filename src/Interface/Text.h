@@ -65,6 +65,12 @@ public:
 	static std::wstring formatFunding(int funds);
 	/// Formats an integer value as percentage.
 	static std::wstring formatPercentage(int value);
+	/// Gets the amount of strings laid out from the cache.
+	static size_t getLayoutHits();
+	/// Gets the amount of strings that missed the cache.
+	static size_t getLayoutMisses();
+	/// Clears the shared layout cache.
+	static void clearLayoutCache();
 	/// Sets the text size to big.
 	void setBig();
 	/// Sets the text size to small.
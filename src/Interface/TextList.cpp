@@ -209,7 +209,19 @@ int TextList::getColumnX(int column) const
  */
 int TextList::getRowY(int row) const
 {
-	return getY() + _texts[row][0]->getY();
+	int line = (int)getFirstLine(row) - (int)_scroll;
+	return getY() + line * (_font->getHeight() + _font->getSpacing());
+}
+
+/**
+ * Returns the first physical row taken up by a text row,
+ * so rows can be placed without walking the whole list.
+ * @param row Row number.
+ * @return Physical row number.
+ */
+size_t TextList::getFirstLine(size_t row) const
+{
+	return std::lower_bound(_rows.begin(), _rows.end(), (int)row) - _rows.begin();
 }
 
 /**
@@ -310,9 +322,23 @@ void TextList::addRow(int cols, ...)
 		_rows.push_back(_texts.size() - 1);
 	}
 
+	addArrows();
 
-	// Place arrow buttons
-	if (_arrowPos != -1)
+	_redraw = true;
+	va_end(args);
+	updateArrows();
+}
+
+/**
+ * Creates the arrow buttons for the rows that can fit on
+ * screen. Only one pair is kept per visible row, and the
+ * pairs are reused for whichever rows are scrolled into view.
+ */
+void TextList::addArrows()
+{
+	if (_arrowPos == -1)
+		return;
+	while (_arrowLeft.size() < std::min(_texts.size(), _visibleRows))
 	{
 		ArrowShape shape1, shape2;
 		if (_arrowType == ARROW_VERTICAL)
@@ -342,10 +368,6 @@ void TextList::addRow(int cols, ...)
 		a2->onMouseRelease(_rightRelease);
 		_arrowRight.push_back(a2);
 	}
-
-	_redraw = true;
-	va_end(args);
-	updateArrows();
 }
 
 /**
@@ -830,6 +852,7 @@ void TextList::updateVisible()
 	{
 		_visibleRows++;
 	}
+	addArrows();
 	updateArrows();
 }
 
@@ -856,8 +879,12 @@ void TextList::setScrolling(bool scrolling, int scrollPos)
 void TextList::draw()
 {
 	Surface::draw();
-	int y = _scroll * -(_font->getHeight() + _font->getSpacing());
-	for (size_t i = 0; i < _texts.size() && i < _scroll + _visibleRows; ++i)
+	if (_scroll >= _rows.size())
+		return;
+	// Start from the row at the top, which may be a wrapped row cut in half
+	size_t first = _rows[_scroll];
+	int y = ((int)getFirstLine(first) - (int)_scroll) * (_font->getHeight() + _font->getSpacing());
+	for (size_t i = first; i < _texts.size() && y < getHeight(); ++i)
 	{
 		for (std::vector<Text*>::iterator j = _texts[i].begin(); j < _texts[i].end(); ++j)
 		{
@@ -890,11 +917,11 @@ void TextList::blit(Surface *surface)
 	{
 		if (_arrowPos != -1)
 		{
-			for (size_t i = _scroll; i < _texts.size() && i < _scroll + _visibleRows; ++i)
+			for (size_t i = 0; i < _arrowLeft.size() && _scroll + i < _texts.size(); ++i)
 			{
-				_arrowLeft[i]->setY(getY() + (i - _scroll) * (_font->getHeight() + _font->getSpacing()));
+				_arrowLeft[i]->setY(getY() + i * (_font->getHeight() + _font->getSpacing()));
 				_arrowLeft[i]->blit(surface);
-				_arrowRight[i]->setY(getY() + (i - _scroll) * (_font->getHeight() + _font->getSpacing()));
+				_arrowRight[i]->setY(getY() + i * (_font->getHeight() + _font->getSpacing()));
 				_arrowRight[i]->blit(surface);
 			}
 		}
@@ -917,7 +944,7 @@ void TextList::handle(Action *action, State *state)
 	_scrollbar->handle(action, state);
 	if (_arrowPos != -1)
 	{
-		for (size_t i = _scroll; i < _texts.size() && i < _scroll + _visibleRows; ++i)
+		for (size_t i = 0; i < _arrowLeft.size() && _scroll + i < _texts.size(); ++i)
 		{
 			_arrowLeft[i]->handle(action, state);
 			_arrowRight[i]->handle(action, state);
@@ -1033,7 +1060,7 @@ void TextList::mouseOver(Action *action, State *state)
 		if (_selRow < _rows.size())
 		{
 			Text *selText = _texts[_rows[_selRow]].front();
-			_selector->setY(getY() + selText->getY());
+			_selector->setY(getRowY(_rows[_selRow]));
 			if (_selector->getHeight() != selText->getHeight() + _font->getSpacing())
 			{
 				_selector->setHeight(selText->getHeight() + _font->getSpacing());
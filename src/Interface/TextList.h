@@ -66,6 +66,10 @@ private:
 	void updateArrows();
 	/// Updates the visible rows.
 	void updateVisible();
+	/// Creates the arrow buttons for the visible rows.
+	void addArrows();
+	/// Gets the first physical row of a text row.
+	size_t getFirstLine(size_t row) const;
 public:
 	/// Creates a text list with the specified size and position.
 	TextList(int width, int height, int x = 0, int y = 0);
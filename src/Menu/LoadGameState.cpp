@@ -20,6 +20,7 @@
 #include <sstream>
 #include "../Engine/Logger.h"
 #include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/SaveWriter.h"
 #include "../Engine/Game.h"
 #include "../Engine/Action.h"
 #include "../Engine/Exception.h"
@@ -136,6 +137,9 @@ void LoadGameState::init()
 	_game->getScreen()->flip();
 	_game->popState();
 
+	// Make sure it's not still being saved
+	_game->getSaveWriter()->wait();
+
 	// Load the game
 	SavedGame *s = new SavedGame();
 	try
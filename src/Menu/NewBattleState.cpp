@@ -307,7 +307,7 @@ void NewBattleState::load(const std::string &filename)
 			}
 
 			// Generate items
-			base->getItems()->getContents()->clear();
+			base->getItems()->clear();
 			const std::vector<std::string> &items = rule->getItemsList();
 			for (std::vector<std::string>::const_iterator i = items.begin(); i != items.end(); ++i)
 			{
@@ -318,16 +318,8 @@ void NewBattleState::load(const std::string &filename)
 				}
 			}
 
-			// Clear invalid contents
+			// Invalid contents were left out when loading
 			_craft = base->getCrafts()->front();
-			for (std::map<std::string, int>::iterator i = _craft->getItems()->getContents()->begin(); i != _craft->getItems()->getContents()->end(); ++i)
-			{
-				RuleItem *rule = _game->getRuleset()->getItem(i->first);
-				if (!rule)
-				{
-					i->second = 0;
-				}
-			}
 
 			_game->setSavedGame(save);
 		}
@@ -391,7 +383,7 @@ void NewBattleState::initSave()
 	base->getSoldiers()->clear();
 	for (std::vector<Craft*>::iterator i = base->getCrafts()->begin(); i != base->getCrafts()->end(); ++i) delete (*i);
 	base->getCrafts()->clear();
-	base->getItems()->getContents()->clear();
+	base->getItems()->clear();
 
 	_craft = new Craft(rule->getCraft(_crafts[_cbxCraft->getSelected()]), base, 1);
 	base->getCrafts()->push_back(_craft);
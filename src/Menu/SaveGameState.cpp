@@ -28,6 +28,7 @@
 #include "../Engine/Language.h"
 #include "../Engine/Palette.h"
 #include "../Interface/Text.h"
+#include "../Savegame/SaveWriter.h"
 #include "ErrorMessageState.h"
 #include "MainMenuState.h"
 
@@ -149,16 +150,20 @@ void SaveGameState::init()
 		break;
 	}
 
-	// Save the game
+	// Save the game, automatic saves are written in the background
+	// and any errors show up later
 	try
 	{
-		std::string backup = _filename + ".bak";
-		_game->getSavedGame()->save(backup);
-		std::string fullPath = Options::getUserFolder() + _filename;
-		std::string bakPath = Options::getUserFolder() + backup;
-		if (!CrossPlatform::moveFile(bakPath, fullPath))
+		SaveWriter *writer = _game->getSaveWriter();
+		int job = writer->save(_filename, _game->getSavedGame()->serialize());
+		if (_type == SAVE_DEFAULT || _type == SAVE_IRONMAN_END)
 		{
-			throw Exception("Save backed up in " + backup);
+			std::string error;
+			writer->wait();
+			if (writer->getError(job, &error))
+			{
+				throw Exception(error);
+			}
 		}
 
 		if (_type == SAVE_IRONMAN_END)
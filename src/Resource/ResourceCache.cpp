@@ -0,0 +1,260 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ResourceCache.h"
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Logger.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+const char CACHE_MAGIC[] = "OXCCACHE";
+const Uint32 CACHE_VERSION = 2;
+
+/**
+ * Reads a 32-bit value out of the blob.
+ * @param blob Cache data.
+ * @param pos Current position, moved past the value.
+ * @param value Where to put the value.
+ * @return False if the blob ended first.
+ */
+bool readValue(const std::vector<Uint8> &blob, size_t *pos, Uint32 *value)
+{
+	if (blob.size() - *pos < sizeof(*value))
+		return false;
+	memcpy(value, &blob[*pos], sizeof(*value));
+	*pos += sizeof(*value);
+	return true;
+}
+
+/**
+ * Reads a length-prefixed string out of the blob.
+ * @param blob Cache data.
+ * @param pos Current position, moved past the string.
+ * @param s Where to put the string.
+ * @return False if the blob ended first.
+ */
+bool readString(const std::vector<Uint8> &blob, size_t *pos, std::string *s)
+{
+	Uint32 length;
+	if (!readValue(blob, pos, &length) || blob.size() - *pos < length)
+		return false;
+	s->assign((const char*)&blob[0] + *pos, length);
+	*pos += length;
+	return true;
+}
+
+/**
+ * Writes a 32-bit value to the cache file.
+ * @param out Output stream.
+ * @param value Value to write.
+ */
+void writeValue(std::ofstream &out, Uint32 value)
+{
+	out.write((const char*)&value, sizeof(value));
+}
+
+/**
+ * Writes a length-prefixed string to the cache file.
+ * @param out Output stream.
+ * @param s String to write.
+ */
+void writeString(std::ofstream &out, const std::string &s)
+{
+	writeValue(out, s.size());
+	out.write(s.c_str(), s.size());
+}
+
+}
+
+/**
+ * Loads the cache file and indexes its entries. A missing,
+ * outdated or damaged file just leaves the cache empty.
+ * @param filename Full path to the cache file.
+ */
+ResourceCache::ResourceCache(const std::string &filename) : _filename(filename), _hits(0), _misses(0), _changed(false)
+{
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!file)
+		return;
+	file.seekg(0, std::ios::end);
+	std::streamoff size = file.tellg();
+	file.seekg(0, std::ios::beg);
+	if (size < (std::streamoff)(sizeof(CACHE_MAGIC) + sizeof(CACHE_VERSION)))
+		return;
+	_blob.resize((size_t)size);
+	if (!file.read((char*)&_blob[0], size))
+	{
+		_blob.clear();
+		return;
+	}
+	file.close();
+
+	size_t pos = sizeof(CACHE_MAGIC);
+	Uint32 version;
+	if (memcmp(&_blob[0], CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || !readValue(_blob, &pos, &version) || version != CACHE_VERSION)
+	{
+		Log(LOG_INFO) << "Resource cache is outdated, rebuilding it.";
+		_blob.clear();
+		return;
+	}
+	while (pos < _blob.size())
+	{
+		std::string name;
+		Entry entry;
+		Uint32 length;
+		if (!readString(_blob, &pos, &name) || !readString(_blob, &pos, &entry.stamp) || !readValue(_blob, &pos, &length) || _blob.size() - pos < length)
+		{
+			Log(LOG_WARNING) << "Resource cache is damaged, rebuilding it.";
+			_entries.clear();
+			_blob.clear();
+			return;
+		}
+		entry.offset = pos;
+		entry.size = length;
+		_entries[name] = entry;
+		pos += length;
+	}
+}
+
+/**
+ *
+ */
+ResourceCache::~ResourceCache()
+{
+}
+
+/**
+ * Builds the stamp that identifies a version of a source file.
+ * Since mods replace data files by path, this also changes
+ * whenever a different mod provides the file.
+ * @param path Full path to the file.
+ * @return Stamp string.
+ */
+std::string ResourceCache::getStamp(const std::string &path)
+{
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+	std::streamoff size = -1;
+	if (file)
+	{
+		file.seekg(0, std::ios::end);
+		size = file.tellg();
+	}
+	std::ostringstream ss;
+	ss << path << ":" << size << ":" << CrossPlatform::getDateModified(path);
+	return ss.str();
+}
+
+/**
+ * Looks up a resource in the cache, counting a miss if it's
+ * not there or was decoded from a different file.
+ * The data is copied out, since storing more resources
+ * moves the cache around.
+ * @param name Name of the resource.
+ * @param stamp Stamp of the file it comes from.
+ * @param data Where to put a copy of the cached data.
+ * @return True if the resource was in the cache.
+ */
+bool ResourceCache::find(const std::string &name, const std::string &stamp, std::vector<Uint8> *data)
+{
+	std::map<std::string, Entry>::const_iterator i = _entries.find(name);
+	if (i == _entries.end() || i->second.stamp != stamp)
+	{
+		_misses++;
+		return false;
+	}
+	_hits++;
+	data->assign(_blob.begin() + i->second.offset, _blob.begin() + i->second.offset + i->second.size);
+	return true;
+}
+
+/**
+ * Adds a freshly decoded resource to the cache,
+ * replacing whatever was stored under its name.
+ * @param name Name of the resource.
+ * @param stamp Stamp of the file it comes from.
+ * @param data Pointer to the decoded data.
+ * @param size Size of the data.
+ */
+void ResourceCache::store(const std::string &name, const std::string &stamp, const void *data, size_t size)
+{
+	Entry entry;
+	entry.stamp = stamp;
+	entry.offset = _blob.size();
+	entry.size = size;
+	_blob.insert(_blob.end(), (const Uint8*)data, (const Uint8*)data + size);
+	_entries[name] = entry;
+	_changed = true;
+}
+
+/**
+ * Writes all the entries back to the cache file,
+ * if anything was added since it was loaded.
+ */
+void ResourceCache::save()
+{
+	if (!_changed)
+		return;
+	std::ofstream file(_filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		Log(LOG_WARNING) << "Failed to save " << _filename;
+		return;
+	}
+	file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	writeValue(file, CACHE_VERSION);
+	for (std::map<std::string, Entry>::const_iterator i = _entries.begin(); i != _entries.end(); ++i)
+	{
+		writeString(file, i->first);
+		writeString(file, i->second.stamp);
+		writeValue(file, i->second.size);
+		if (i->second.size > 0)
+		{
+			file.write((const char*)&_blob[i->second.offset], i->second.size);
+		}
+	}
+	file.close();
+	_changed = false;
+}
+
+/**
+ * Returns how many resources were found in the cache.
+ * @return Number of hits.
+ */
+int ResourceCache::getHits() const
+{
+	return _hits;
+}
+
+/**
+ * Returns how many resources weren't in the cache.
+ * @return Number of misses.
+ */
+int ResourceCache::getMisses() const
+{
+	return _misses;
+}
+
+}
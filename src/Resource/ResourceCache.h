@@ -0,0 +1,73 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OPENXCOM_RESOURCECACHE_H
+#define OPENXCOM_RESOURCECACHE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <SDL.h>
+
+namespace OpenXcom
+{
+
+/**
+ * On-disk cache of resources that take work to decode,
+ * kept in the user folder between runs.
+ * Each entry remembers a stamp of the file it was decoded
+ * from (path, size and modification time), so changing the
+ * game data or mods invalidates just the entries affected.
+ * The whole cache is read in one go into a single blob.
+ */
+class ResourceCache
+{
+private:
+	struct Entry
+	{
+		std::string stamp;
+		size_t offset, size;
+	};
+	std::string _filename;
+	std::vector<Uint8> _blob;
+	std::map<std::string, Entry> _entries;
+	int _hits, _misses;
+	bool _changed;
+public:
+	/// Loads the cache from a file.
+	ResourceCache(const std::string &filename);
+	/// Cleans up the cache.
+	~ResourceCache();
+	/// Gets the stamp of a source file.
+	static std::string getStamp(const std::string &path);
+	/// Looks up a cached resource.
+	bool find(const std::string &name, const std::string &stamp, std::vector<Uint8> *data);
+	/// Stores a decoded resource.
+	void store(const std::string &name, const std::string &stamp, const void *data, size_t size);
+	/// Saves the cache to its file if it changed.
+	void save();
+	/// Gets the number of resources found in the cache.
+	int getHits() const;
+	/// Gets the number of resources that had to be decoded.
+	int getMisses() const;
+};
+
+}
+
+#endif
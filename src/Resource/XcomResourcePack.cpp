@@ -45,6 +45,7 @@
 #include "../Ruleset/ExtraSprites.h"
 #include "../Ruleset/ExtraSounds.h"
 #include "../Engine/AdlibMusic.h"
+#include "ResourceCache.h"
 
 namespace OpenXcom
 {
@@ -74,8 +75,12 @@ struct HairBleach
  * Initializes the resource pack by loading all the resources
  * contained in the original game folder.
  */
-XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprites *> > extraSprites, std::vector<std::pair<std::string, ExtraSounds *> > extraSounds) : ResourcePack()
+XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprites *> > extraSprites, std::vector<std::pair<std::string, ExtraSounds *> > extraSounds) : ResourcePack(), _cache(0)
 {
+	Uint32 startTime = SDL_GetTicks();
+	ResourceCache cache(Options::getUserFolder() + "resources.cache");
+	_cache = &cache;
+
 	// Load palettes
 	const char *pal[] = {"PAL_GEOSCAPE", "PAL_BASESCAPE", "PAL_GRAPHS", "PAL_UFOPAEDIA", "PAL_BATTLEPEDIA"};
 	for (size_t i = 0; i < sizeof(pal) / sizeof(pal[0]); ++i)
@@ -705,6 +710,10 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 			}
 		}
 	}
+
+	cache.save();
+	_cache = 0;
+	Log(LOG_INFO) << "Resources loaded in " << SDL_GetTicks() - startTime << "ms (" << cache.getHits() << " cached, " << cache.getMisses() << " decoded).";
 }
 
 /**
@@ -956,7 +965,31 @@ Music *XcomResourcePack::loadMusic(MusicFormat fmt, const std::string &file, int
 		else if (fmt == MUSIC_MIDI)
 		{
 			// DOS MIDI
-			if (gmcat)
+			if (gmcat && _cache)
+			{
+				// converting the streams is slow, so keep the results around
+				std::ostringstream name;
+				name << "GM.CAT/" << track;
+				std::string stamp = ResourceCache::getStamp(CrossPlatform::getDataFile("SOUND/GM.CAT"));
+				std::vector<unsigned char> midi;
+				if (!_cache->find(name.str(), stamp, &midi))
+				{
+					if (gmcat->convertMIDI(track, midi))
+					{
+						_cache->store(name.str(), stamp, &midi[0], midi.size());
+					}
+					else
+					{
+						midi.clear();
+					}
+				}
+				music = new Music();
+				if (!midi.empty())
+				{
+					music->load(&midi[0], midi.size());
+				}
+			}
+			else if (gmcat)
 			{
 				music = gmcat->loadMIDI(track);
 			}
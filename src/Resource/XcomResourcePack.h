@@ -30,12 +30,15 @@ class ExtraSounds;
 class CatFile;
 class GMCatFile;
 class Music;
+class ResourceCache;
 
 /**
  * Resource pack for the X-Com: UFO Defense game.
  */
 class XcomResourcePack : public ResourcePack
 {
+private:
+	ResourceCache *_cache;
 public:
 	/// Creates the X-Com ruleset.
 	XcomResourcePack(std::vector<std::pair<std::string, ExtraSprites *> > extraSprites, std::vector<std::pair<std::string, ExtraSounds *> > extraSounds);
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_LOCATIONGRID_H
+#define OPENXCOM_LOCATIONGRID_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace OpenXcom
+{
+
+/**
+ * Splits the globe into a grid of cells, each one listing
+ * the areas (countries, regions) that overlap it, so finding
+ * which area a point is in only has to check a couple of them.
+ * Areas are listed in the order they were added, so the first
+ * match is the same as checking them all in that order.
+ * @tparam T Area rule, with lists of lat/lon rectangles.
+ */
+template <typename T>
+class LocationGrid
+{
+private:
+	// each cell covers 2x2 degrees
+	static const int COLUMNS = 180, ROWS = 90;
+	std::vector<std::vector<T*> > _cells;
+	std::vector<T*> _all;
+
+	/// Gets the column a longitude falls in.
+	static int getColumn(double lon)
+	{
+		int x = (int)floor(lon / (2 * M_PI) * COLUMNS);
+		return std::max(0, std::min(COLUMNS - 1, x));
+	}
+	/// Gets the row a latitude falls in.
+	static int getRow(double lat)
+	{
+		int y = (int)floor((lat + M_PI / 2) / M_PI * ROWS);
+		return std::max(0, std::min(ROWS - 1, y));
+	}
+	/// Adds an area to a block of cells.
+	void addCells(T *area, int x1, int x2, int y1, int y2)
+	{
+		for (int y = y1; y <= y2; ++y)
+		{
+			for (int x = x1; x <= x2; ++x)
+			{
+				std::vector<T*> &cell = _cells[y * COLUMNS + x];
+				if (cell.empty() || cell.back() != area)
+				{
+					cell.push_back(area);
+				}
+			}
+		}
+	}
+public:
+	/// Creates an empty grid.
+	LocationGrid() : _cells(COLUMNS * ROWS)
+	{
+	}
+
+	/// Removes all the areas.
+	void clear()
+	{
+		_cells.assign(COLUMNS * ROWS, std::vector<T*>());
+		_all.clear();
+	}
+
+	/**
+	 * Adds an area to every cell its rectangles touch.
+	 * Rectangles crossing the 0 meridian wrap around.
+	 * @param area Pointer to the area rule.
+	 */
+	void add(T *area)
+	{
+		_all.push_back(area);
+		for (size_t i = 0; i < area->getLonMin().size(); ++i)
+		{
+			double lonMin = area->getLonMin()[i], lonMax = area->getLonMax()[i];
+			int y1 = getRow(area->getLatMin()[i]), y2 = getRow(area->getLatMax()[i]);
+			if (lonMin <= lonMax)
+			{
+				addCells(area, getColumn(lonMin), getColumn(lonMax), y1, y2);
+			}
+			else
+			{
+				addCells(area, getColumn(lonMin), COLUMNS - 1, y1, y2);
+				addCells(area, 0, getColumn(lonMax), y1, y2);
+			}
+		}
+	}
+
+	/**
+	 * Gets the areas that might contain a point.
+	 * Points off the grid get every area.
+	 * @param lon Longitude in radians.
+	 * @param lat Latitude in radians.
+	 * @return List of areas, in the order they were added.
+	 */
+	const std::vector<T*> &getCandidates(double lon, double lat) const
+	{
+		if (!(lon >= 0 && lon < 2 * M_PI && lat >= -M_PI / 2 && lat <= M_PI / 2))
+		{
+			return _all;
+		}
+		return _cells[getRow(lat) * COLUMNS + getColumn(lon)];
+	}
+};
+
+}
+
+#endif
@@ -68,6 +68,7 @@ private:
 	std::string _zombieUnit;
 	bool _strengthApplied, _skillApplied, _LOSRequired;
 	int _meleeSound, _meleePower, _meleeAnimation, _meleeHitSound;
+	int _index;
 public:
 	/// Creates a blank item ruleset.
 	RuleItem(const std::string &type);
@@ -219,6 +220,10 @@ public:
 	int getMeleeAnimation() const;
 	/// Check if LOS is required to use this item (only applies to psionic type items)
 	bool isLOSRequired() const;
+	/// Gets the number the ruleset gave this item.
+	int getIndex() const;
+	/// Sets the number the ruleset gave this item.
+	void setIndex(int index);
 };
 
 }
@@ -21,7 +21,7 @@
 namespace OpenXcom
 {
 
-RuleResearch::RuleResearch(const std::string & name) : _name(name), _lookup(""), _cost(0), _points(0), _getOneFree(0), _requires(0), _needItem(false), _listOrder(0)
+RuleResearch::RuleResearch(const std::string & name) : _name(name), _lookup(""), _cost(0), _points(0), _getOneFree(0), _requires(0), _needItem(false), _listOrder(0), _index(-1)
 {
 }
 
@@ -138,4 +138,23 @@ int RuleResearch::getListOrder() const
 	return _listOrder;
 }
 
+/**
+ * Gets the number this research has in the ruleset's research list,
+ * for keeping track of research in flat tables instead of by name.
+ * @return Research number, or -1 if it's not in the list.
+ */
+int RuleResearch::getIndex() const
+{
+	return _index;
+}
+
+/**
+ * Sets the number this research has in the ruleset's research list.
+ * @param index Research number.
+ */
+void RuleResearch::setIndex(int index)
+{
+	_index = index;
+}
+
 }
@@ -44,7 +44,7 @@ class RuleResearch
 	int _cost, _points;
 	std::vector<std::string> _dependencies, _unlocks, _getOneFree, _requires;
 	bool _needItem;
-	int _listOrder;
+	int _listOrder, _index;
 public:
 	RuleResearch(const std::string & name);
 	/// Loads the research from YAML.
@@ -69,6 +69,10 @@ public:
 	const std::vector<std::string> & getRequirements() const;
 	/// Gets the list weight for this research item.
 	int getListOrder() const;
+	/// Gets the number the ruleset gave this research.
+	int getIndex() const;
+	/// Sets the number the ruleset gave this research.
+	void setIndex(int index);
 };
 }
 
@@ -745,6 +745,20 @@ RuleItem *Ruleset::getItem(const std::string &id) const
 		return 0;
 }
 
+/**
+ * Returns the rules for the item with the specified number,
+ * which is its position in the item list.
+ * @param index Item number.
+ * @return Rules for the item, or 0 if there's no such number.
+ */
+RuleItem *Ruleset::getItemByIndex(int index) const
+{
+	if (index >= 0 && index < (int)_itemsByIndex.size())
+		return _itemsByIndex[index];
+	else
+		return 0;
+}
+
 /**
  * Returns the list of all items
  * provided by the ruleset.
@@ -1125,6 +1139,46 @@ const City *Ruleset::locateCity(double lon, double lat) const
 	return 0;
 }
 
+/**
+ * Finds the country containing coordinates @a lon, @a lat,
+ * the first one in the ruleset's list if they overlap.
+ * @param lon The longitude.
+ * @param lat The latitude.
+ * @return A pointer to the country rules, or 0 if it's not in any.
+ */
+RuleCountry *Ruleset::locateCountry(double lon, double lat) const
+{
+	const std::vector<RuleCountry*> &countries = _countryGrid.getCandidates(lon, lat);
+	for (std::vector<RuleCountry*>::const_iterator i = countries.begin(); i != countries.end(); ++i)
+	{
+		if ((*i)->insideCountry(lon, lat))
+		{
+			return *i;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Finds the region containing coordinates @a lon, @a lat,
+ * the first one in the ruleset's list if they overlap.
+ * @param lon The longitude.
+ * @param lat The latitude.
+ * @return A pointer to the region rules, or 0 if it's not in any.
+ */
+RuleRegion *Ruleset::locateRegion(double lon, double lat) const
+{
+	const std::vector<RuleRegion*> &regions = _regionGrid.getCandidates(lon, lat);
+	for (std::vector<RuleRegion*>::const_iterator i = regions.begin(); i != regions.end(); ++i)
+	{
+		if ((*i)->insideRegion(lon, lat))
+		{
+			return *i;
+		}
+	}
+	return 0;
+}
+
 /**
  * Gets the alien item level table.
  * @return A deep array containing the alien item levels.
@@ -1297,7 +1351,8 @@ struct compareRule<ArticleDefinition> : public std::binary_function<const std::s
 std::map<std::string, int> compareRule<ArticleDefinition>::_sections;
 
 /**
- * Sorts all our lists according to their weight.
+ * Sorts all our lists according to their weight,
+ * and numbers the items and research in that order.
  */
 void Ruleset::sortLists()
 {
@@ -1311,6 +1366,37 @@ void Ruleset::sortLists()
 	std::sort(_craftWeaponsIndex.begin(), _craftWeaponsIndex.end(), compareRule<RuleCraftWeapon>(this));
 	std::sort(_armorsIndex.begin(), _armorsIndex.end(), compareRule<Armor>(this));
 	std::sort(_ufopaediaIndex.begin(), _ufopaediaIndex.end(), compareRule<ArticleDefinition>(this));
+
+	_itemsByIndex.clear();
+	for (size_t i = 0; i < _itemsIndex.size(); ++i)
+	{
+		RuleItem *item = _items[_itemsIndex[i]];
+		item->setIndex(i);
+		_itemsByIndex.push_back(item);
+	}
+	for (size_t i = 0; i < _researchIndex.size(); ++i)
+	{
+		_research[_researchIndex[i]]->setIndex(i);
+	}
+}
+
+/**
+ * Sorts the countries and regions into grids covering
+ * the globe, so locating them doesn't check every one.
+ * Must be called once all the rulesets are loaded.
+ */
+void Ruleset::buildLocationGrids()
+{
+	_countryGrid.clear();
+	for (std::vector<std::string>::const_iterator i = _countriesIndex.begin(); i != _countriesIndex.end(); ++i)
+	{
+		_countryGrid.add(getCountry(*i));
+	}
+	_regionGrid.clear();
+	for (std::vector<std::string>::const_iterator i = _regionsIndex.begin(); i != _regionsIndex.end(); ++i)
+	{
+		_regionGrid.add(getRegion(*i));
+	}
 }
 
 /**
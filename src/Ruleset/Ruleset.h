@@ -24,6 +24,7 @@
 #include <string>
 #include <yaml-cpp/yaml.h>
 #include "../Savegame/GameTime.h"
+#include "LocationGrid.h"
 
 namespace OpenXcom
 {
@@ -76,6 +77,7 @@ protected:
 	std::map<std::string, RuleCraft*> _crafts;
 	std::map<std::string, RuleCraftWeapon*> _craftWeapons;
 	std::map<std::string, RuleItem*> _items;
+	std::vector<RuleItem*> _itemsByIndex;
 	std::map<std::string, RuleUfo*> _ufos;
 	std::map<std::string, RuleTerrain*> _terrains;
 	std::map<std::string, MapDataSet*> _mapDataSets;
@@ -104,6 +106,8 @@ protected:
 	std::vector<std::vector<int> > _alienItemLevels;
 	int _modIndex, _facilityListOrder, _craftListOrder, _itemListOrder, _researchListOrder,  _manufactureListOrder, _ufopaediaListOrder, _invListOrder;
 	std::vector<std::string> _psiRequirements; // it's a cache for psiStrengthEval
+	LocationGrid<RuleCountry> _countryGrid;
+	LocationGrid<RuleRegion> _regionGrid;
 	/// Loads a ruleset from a YAML file.
 	void loadFile(const std::string &filename);
 	/// Loads all ruleset files from a directory.
@@ -144,6 +148,8 @@ public:
 	const std::vector<std::string> &getCraftWeaponsList() const;
 	/// Gets the ruleset for an item type.
 	RuleItem *getItem(const std::string &id) const;
+	/// Gets the ruleset for an item number.
+	RuleItem *getItemByIndex(int index) const;
 	/// Gets the available items.
 	const std::vector<std::string> &getItemsList() const;
 	/// Gets the ruleset for a UFO type.
@@ -206,6 +212,10 @@ public:
 	const std::vector<std::string> &getAlienMissionList() const;
 	/// Gets the city at the specified coordinates.
 	const City *locateCity(double lon, double lat) const;
+	/// Gets the country at the specified coordinates.
+	RuleCountry *locateCountry(double lon, double lat) const;
+	/// Gets the region at the specified coordinates.
+	RuleRegion *locateRegion(double lon, double lat) const;
 	/// Gets the alien item level table.
 	const std::vector<std::vector<int> > &getAlienItemLevels() const;
 	/// Gets the Defined starting base.
@@ -222,6 +232,8 @@ public:
     std::vector<StatString *> getStatStrings() const;    
 	/// Sorts all our lists according to their weight.
 	void sortLists();
+	/// Builds the lookup grids for countries and regions.
+	void buildLocationGrids();
 	/// Gets the research-requirements for Psi-Lab (it's a cache for psiStrengthEval)
 	std::vector<std::string> getPsiRequirements() const;
 	/// Returns the sorted list of inventories.
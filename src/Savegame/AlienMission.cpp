@@ -627,21 +627,13 @@ const AlienBase *AlienMission::getAlienBase() const
  */
 void AlienMission::addScore(const double lon, const double lat, Game &engine)
 {
-	for (std::vector<Region *>::iterator region = engine.getSavedGame()->getRegions()->begin(); region != engine.getSavedGame()->getRegions()->end(); ++region)
+	if (Region *region = engine.getSavedGame()->locateRegion(engine.getRuleset(), lon, lat))
 	{
-		if ((*region)->getRules()->insideRegion(lon, lat))
-		{
-			(*region)->addActivityAlien(_rule.getPoints());
-			break;
-		}
+		region->addActivityAlien(_rule.getPoints());
 	}
-	for (std::vector<Country *>::iterator country = engine.getSavedGame()->getCountries()->begin(); country != engine.getSavedGame()->getCountries()->end(); ++country)
+	if (Country *country = engine.getSavedGame()->locateCountry(engine.getRuleset(), lon, lat))
 	{
-		if ((*country)->getRules()->insideCountry(lon, lat))
-		{
-			(*country)->addActivityAlien(_rule.getPoints());
-			break;
-		}
+		country->addActivityAlien(_rule.getPoints());
 	}
 }
 
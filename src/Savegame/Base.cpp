@@ -21,6 +21,7 @@
 #include <cmath>
 #include <stack>
 #include <algorithm>
+#include <climits>
 #include "BaseFacility.h"
 #include "../Ruleset/RuleBaseFacility.h"
 #include "Craft.h"
@@ -51,9 +52,9 @@ namespace OpenXcom
  * Initializes an empty base.
  * @param rule Pointer to ruleset.
  */
-Base::Base(const Ruleset *rule) : Target(), _rule(rule), _name(L""), _scientists(0), _engineers(0), _inBattlescape(false), _retaliationTarget(false)
+Base::Base(const Ruleset *rule) : Target(), _rule(rule), _name(L""), _scientists(0), _engineers(0), _inBattlescape(false), _retaliationTarget(false), _hyperwaveRange(-1.0), _radarDirty(true)
 {
-	_items = new ItemContainer();
+	_items = new ItemContainer(rule);
 }
 
 /**
@@ -151,19 +152,8 @@ void Base::load(const YAML::Node &node, SavedGame *save, bool newGame, bool newB
 		_soldiers.push_back(s);
 	}
 
+	// Some old saves have bad items, the container leaves them out
 	_items->load(node["items"]);
-	// Some old saves have bad items, better get rid of them to avoid further bugs
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end();)
-	{
-		if (std::find(_rule->getItemsList().begin(), _rule->getItemsList().end(), i->first) == _rule->getItemsList().end())
-		{
-			_items->getContents()->erase(i++);
-		}
-		else
-		{
-			++i;
-		}
-	}
 
 	_scientists = node["scientists"].as<int>(_scientists);
 	_engineers = node["engineers"].as<int>(_engineers);
@@ -321,6 +311,15 @@ ItemContainer *Base::getItems()
 	return _items;
 }
 
+/**
+ * Returns the ruleset the base was created with.
+ * @return Pointer to the ruleset.
+ */
+const Ruleset *Base::getRuleset() const
+{
+	return _rule;
+}
+
 /**
  * Returns the amount of scientists currently in the base.
  * @return Number of scientists.
@@ -357,6 +356,52 @@ void Base::setEngineers(int engineers)
 	 _engineers = engineers;
 }
 
+/**
+ * Summarizes the radar coverage of the finished facilities:
+ * the longest hyper-wave range, and for every distinct radar
+ * range the summed chance of all facilities reaching at least
+ * that far. Bands are sorted by ascending range.
+ */
+void Base::updateRadar() const
+{
+	_radarBands.clear();
+	_hyperwaveRange = -1.0;
+	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
+	{
+		if ((*i)->getBuildTime() != 0)
+			continue;
+		double range = (*i)->getRules()->getRadarRange();
+		if ((*i)->getRules()->isHyperwave())
+		{
+			_hyperwaveRange = std::max(_hyperwaveRange, range);
+		}
+		std::vector<std::pair<double, int> >::iterator band = std::lower_bound(_radarBands.begin(), _radarBands.end(), std::make_pair(range, INT_MIN));
+		if (band != _radarBands.end() && band->first == range)
+		{
+			band->second += (*i)->getRules()->getRadarChance();
+		}
+		else
+		{
+			_radarBands.insert(band, std::make_pair(range, (*i)->getRules()->getRadarChance()));
+		}
+	}
+	for (int i = (int)_radarBands.size() - 2; i >= 0; --i)
+	{
+		_radarBands[i].second += _radarBands[i + 1].second;
+	}
+	_radarDirty = false;
+}
+
+/**
+ * Marks the radar coverage summary as stale, so it's
+ * rebuilt on the next detection check. Must be called
+ * whenever a facility is finished, added or removed.
+ */
+void Base::invalidateRadar()
+{
+	_radarDirty = true;
+}
+
 /**
  * Returns if a certain target is covered by the base's
  * radar range, taking in account the range and chance.
@@ -365,19 +410,16 @@ void Base::setEngineers(int engineers)
  */
 int Base::detect(Target *target) const
 {
-	int chance = 0;
+	if (_radarDirty)
+		updateRadar();
 	double distance = getDistance(target) * 60.0 * (180.0 / M_PI);
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
+	if (_hyperwaveRange >= distance)
 	{
-		if ((*i)->getRules()->getRadarRange() >= distance && (*i)->getBuildTime() == 0)
-		{
-			if ((*i)->getRules()->isHyperwave())
-			{
-				return 2;
-			}
-			chance += (*i)->getRules()->getRadarChance();
-		}
+		return 2;
 	}
+	std::vector<std::pair<double, int> >::const_iterator band = std::lower_bound(_radarBands.begin(), _radarBands.end(), std::make_pair(distance, INT_MIN));
+	if (band == _radarBands.end()) return 0;
+	int chance = band->second;
 	if (chance == 0) return 0;
 
 	Ufo *u = dynamic_cast<Ufo*>(target);
@@ -397,21 +439,16 @@ int Base::detect(Target *target) const
  */
 int Base::insideRadarRange(Target *target) const
 {
-	bool insideRange = false;
+	if (_radarDirty)
+		updateRadar();
+	if (_radarBands.empty())
+		return 0;
 	double distance = getDistance(target) * 60.0 * (180.0 / M_PI);
-	for (std::vector<BaseFacility*>::const_iterator i = _facilities.begin(); i != _facilities.end(); ++i)
+	if (_hyperwaveRange >= distance)
 	{
-		if ((*i)->getRules()->getRadarRange() >= distance && (*i)->getBuildTime() == 0)
-		{
-			if ((*i)->getRules()->isHyperwave())
-			{
-				return 2;
-			}
-			insideRange = true;
-		}
+		return 2;
 	}
-
-	return insideRange? 1 : 0;
+	return (_radarBands.back().first >= distance)? 1 : 0;
 }
 
 /**
@@ -558,10 +595,10 @@ int Base::getAvailableQuarters() const
  */
 double Base::getUsedStores()
 {
-	double total = _items->getTotalSize(_rule);
+	double total = _items->getTotalSize();
 	for (std::vector<Craft*>::const_iterator i = _crafts.begin(); i != _crafts.end(); ++i)
 	{
-		total += (*i)->getItems()->getTotalSize(_rule);
+		total += (*i)->getItems()->getTotalSize();
 		for (std::vector<Vehicle*>::const_iterator j = (*i)->getVehicles()->begin(); j != (*i)->getVehicles()->end(); ++j)
 		{
 			total += (*j)->getRules()->getSize();
@@ -576,7 +613,7 @@ double Base::getUsedStores()
 		else if ((*i)->getType() == TRANSFER_CRAFT)
 		{
 			Craft *craft = (*i)->getCraft();
-			total += craft->getItems()->getTotalSize(_rule);
+			total += craft->getItems()->getTotalSize();
 		}
 	}
 	total -= getIgnoredStores();
@@ -1075,14 +1112,7 @@ int Base::getUsedPsiLabs() const
  */
 int Base::getUsedContainment() const
 {
-	int total = 0;
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); ++i)
-	{
-		if (_rule->getItem((i)->first)->getAlien())
-		{
-			total += (i)->second;
-		}
-	}
+	int total = _items->getTotalAliens();
 	for (std::vector<Transfer*>::const_iterator i = _transfers.begin(); i != _transfers.end(); ++i)
 	{
 		if ((*i)->getType() == TRANSFER_ITEM)
@@ -1253,46 +1283,39 @@ void Base::setupDefenses()
 	}
 
 	// add vehicles left on the base
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); )
-	{
-		std::string itemId = (i)->first;
-		int itemQty = (i)->second;
-		RuleItem *rule = _rule->getItem(itemId);
-		if (rule->isFixed())
+	for (size_t i = 0; i < _rule->getItemsList().size(); ++i)
+	{
+		RuleItem *rule = _rule->getItemByIndex(i);
+		int itemQty = _items->getItem(rule);
+		if (itemQty <= 0 || !rule->isFixed())
+			continue;
+		std::string itemId = rule->getType();
+		int size = 4;
+		if (_rule->getUnit(itemId))
 		{
-			int size = 4;
-			if (_rule->getUnit(itemId))
-			{
-				size = _rule->getArmor(_rule->getUnit(itemId)->getArmor())->getSize();
-			}
-			if (rule->getCompatibleAmmo()->empty()) // so this vehicle does not need ammo
-			{
-				for (int j = 0; j < itemQty; ++j)
-					_vehicles.push_back(new Vehicle(rule, rule->getClipSize(), size));
-				_items->removeItem(itemId, itemQty);
-			}
-			else // so this vehicle needs ammo
+			size = _rule->getArmor(_rule->getUnit(itemId)->getArmor())->getSize();
+		}
+		if (rule->getCompatibleAmmo()->empty()) // so this vehicle does not need ammo
+		{
+			for (int j = 0; j < itemQty; ++j)
+				_vehicles.push_back(new Vehicle(rule, rule->getClipSize(), size));
+			_items->removeItem(rule, itemQty);
+		}
+		else // so this vehicle needs ammo
+		{
+			RuleItem *ammo = _rule->getItem(rule->getCompatibleAmmo()->front());
+			int ammoPerVehicle = ammo->getClipSize();
+			int baseQty = _items->getItem(ammo) / ammoPerVehicle;
+			if (!baseQty)
+				continue;
+			int canBeAdded = std::min(itemQty, baseQty);
+			for (int j=0; j<canBeAdded; ++j)
 			{
-				RuleItem *ammo = _rule->getItem(rule->getCompatibleAmmo()->front());
-				int ammoPerVehicle = ammo->getClipSize();
-				int baseQty = _items->getItem(ammo->getType()) / ammoPerVehicle;
-				if (!baseQty)
-				{
-					++i;
-					continue;
-				}
-				int canBeAdded = std::min(itemQty, baseQty);
-				for (int j=0; j<canBeAdded; ++j)
-				{
-					_vehicles.push_back(new Vehicle(rule, ammoPerVehicle, size));
-					_items->removeItem(ammo->getType(), ammoPerVehicle);
-				}
-				_items->removeItem(itemId, canBeAdded);
+				_vehicles.push_back(new Vehicle(rule, ammoPerVehicle, size));
+				_items->removeItem(ammo, ammoPerVehicle);
 			}
-
-			i = _items->getContents()->begin(); // we have to start over because iterator is broken because of the removeItem
+			_items->removeItem(rule, canBeAdded);
 		}
-		else ++i;
 	}
 }
 
@@ -1437,12 +1460,12 @@ void Base::destroyFacility(std::vector<BaseFacility*>::iterator facility)
 				}
 			}
 			// remove all items
-			while (!(*facility)->getCraft()->getItems()->getContents()->empty())
+			std::map<std::string, int> craftItems = (*facility)->getCraft()->getItems()->getContents();
+			for (std::map<std::string, int>::const_iterator i = craftItems.begin(); i != craftItems.end(); ++i)
 			{
-				std::map<std::string, int>::iterator i = (*facility)->getCraft()->getItems()->getContents()->begin();
 				_items->addItem(i->first, i->second);
-				(*facility)->getCraft()->getItems()->removeItem(i->first, i->second);
 			}
+			(*facility)->getCraft()->getItems()->clear();
 			for (std::vector<Craft*>::iterator i = _crafts.begin(); i != _crafts.end(); ++i)
 			{
 				if (*i == (*facility)->getCraft())
@@ -1586,5 +1609,6 @@ void Base::destroyFacility(std::vector<BaseFacility*>::iterator facility)
 	}
 	delete *facility;
 	_facilities.erase(facility);
+	invalidateRadar();
 }
 }
@@ -62,6 +62,11 @@ private:
 	bool _retaliationTarget;
 	std::vector<Vehicle*> _vehicles;
 	std::vector<BaseFacility*> _defenses;
+	mutable std::vector<std::pair<double, int> > _radarBands;
+	mutable double _hyperwaveRange;
+	mutable bool _radarDirty;
+	/// Rebuilds the cached radar coverage summary.
+	void updateRadar() const;
 	/// Determines space taken up by ammo clips about to rearm craft.
 	double getIgnoredStores();
 public:
@@ -89,6 +94,8 @@ public:
 	std::vector<Transfer*> *getTransfers();
 	/// Gets the base's items.
 	ItemContainer *getItems();
+	/// Gets the base's ruleset.
+	const Ruleset *getRuleset() const;
 	/// Gets the base's scientists.
 	int getScientists() const;
 	/// Sets the base's scientists.
@@ -101,6 +108,8 @@ public:
 	int detect(Target *target) const;
 	/// Checks if a target is inside the base's radar range.
 	int insideRadarRange(Target *target) const;
+	/// Marks the base's radar coverage as changed.
+	void invalidateRadar();
 	/// Gets the base's available soldiers.
 	int getAvailableSoldiers(bool checkCombatReadiness = false) const;
 	/// Gets the base's total soldiers.
@@ -42,6 +42,8 @@
 namespace OpenXcom
 {
 
+int BattleUnit::_spottingGeneration = 0;
+
 /**
  * Initializes a BattleUnit from a Soldier
  * @param soldier Pointer to the Soldier.
@@ -1207,6 +1209,7 @@ bool BattleUnit::addToVisibleUnits(BattleUnit *unit)
 	if (add)
 	{
 		_unitsSpottedThisTurn.push_back(unit);
+		++_spottingGeneration;
 	}
 	for (std::vector<BattleUnit*>::iterator i = _visibleUnits.begin(); i != _visibleUnits.end(); ++i)
 	{
@@ -1410,6 +1413,7 @@ void BattleUnit::prepareNewTurn()
 	_faction = _originalFaction;
 
 	_unitsSpottedThisTurn.clear();
+	++_spottingGeneration;
 
 	// recover TUs
 	int TURecovery = getStats()->tu;
@@ -1597,7 +1601,11 @@ BattleAIState *BattleUnit::getCurrentAIState() const
  */
 void BattleUnit::setVisible(bool flag)
 {
-	_visible = flag;
+	if (flag != _visible)
+	{
+		_visible = flag;
+		++_spottingGeneration;
+	}
 }
 
 
@@ -2324,6 +2332,7 @@ std::string BattleUnit::getActiveHand() const
 void BattleUnit::convertToFaction(UnitFaction f)
 {
 	_faction = f;
+	++_spottingGeneration;
 }
 
 /**
@@ -112,8 +112,19 @@ private:
 	Unit *_unitRules;
 	int _rankInt;
 	int _turretType;
+	static int _spottingGeneration;
 public:
 	static const int MAX_SOLDIER_ID = 1000000;
+	/**
+	 * Gets the generation of unit spotting. It changes every time
+	 * a unit's visibility, faction or spotted units change, so cached
+	 * paths around other units can tell when they are out of date.
+	 * @return generation number.
+	 */
+	static int getSpottingGeneration()
+	{
+		return _spottingGeneration;
+	}
 	/// Creates a BattleUnit.
 	BattleUnit(Soldier *soldier, UnitFaction faction);
 	BattleUnit(Unit *unit, UnitFaction faction, int id, Armor *armor, int diff);
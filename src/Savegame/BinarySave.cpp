@@ -0,0 +1,297 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BinarySave.h"
+#include <algorithm>
+#include <map>
+#include <string>
+#include "../Engine/Exception.h"
+
+namespace OpenXcom
+{
+
+namespace BinarySave
+{
+
+namespace
+{
+
+const char MAGIC[4] = {'O', 'X', 'C', 'B'};
+
+/// Types of stored nodes.
+enum NodeTag { TAG_NULL, TAG_SCALAR, TAG_SEQUENCE, TAG_MAP };
+
+typedef std::map<std::string, size_t> StringTable;
+
+/**
+ * Writes an unsigned number in as few bytes as it needs,
+ * 7 bits at a time with the top bit marking there's more.
+ * @param out Output buffer.
+ * @param value Number to write.
+ */
+void writeNumber(std::string &out, size_t value)
+{
+	while (value >= 0x80)
+	{
+		out += (char)((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+	out += (char)value;
+}
+
+/**
+ * Reads a number written by writeNumber.
+ * @param in Input stream.
+ * @return Number read.
+ */
+size_t readNumber(std::istream &in)
+{
+	size_t value = 0;
+	int shift = 0;
+	int c;
+	do
+	{
+		c = in.get();
+		if (c == EOF || shift >= (int)sizeof(size_t) * 8)
+		{
+			throw Exception("Binary save is corrupt");
+		}
+		value |= (size_t)(c & 0x7F) << shift;
+		shift += 7;
+	}
+	while (c & 0x80);
+	return value;
+}
+
+/**
+ * Adds all the strings in a node to the string table,
+ * numbered in the order they're first found.
+ * @param node YAML node.
+ * @param table String table.
+ * @param strings Strings in table order.
+ */
+void collectStrings(const YAML::Node &node, StringTable &table, std::vector<const std::string*> &strings)
+{
+	switch (node.Type())
+	{
+	case YAML::NodeType::Scalar:
+		{
+			std::pair<StringTable::iterator, bool> i = table.insert(std::make_pair(node.Scalar(), table.size()));
+			if (i.second)
+			{
+				strings.push_back(&i.first->first);
+			}
+		}
+		break;
+	case YAML::NodeType::Sequence:
+		for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
+		{
+			collectStrings(*i, table, strings);
+		}
+		break;
+	case YAML::NodeType::Map:
+		for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
+		{
+			collectStrings(i->first, table, strings);
+			collectStrings(i->second, table, strings);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * Writes a node and all its children.
+ * @param out Output buffer.
+ * @param node YAML node.
+ * @param table String table.
+ */
+void writeNode(std::string &out, const YAML::Node &node, const StringTable &table)
+{
+	switch (node.Type())
+	{
+	case YAML::NodeType::Scalar:
+		out += (char)TAG_SCALAR;
+		writeNumber(out, table.find(node.Scalar())->second);
+		break;
+	case YAML::NodeType::Sequence:
+		out += (char)TAG_SEQUENCE;
+		writeNumber(out, node.size());
+		for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
+		{
+			writeNode(out, *i, table);
+		}
+		break;
+	case YAML::NodeType::Map:
+		out += (char)TAG_MAP;
+		writeNumber(out, node.size());
+		for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
+		{
+			writeNode(out, i->first, table);
+			writeNode(out, i->second, table);
+		}
+		break;
+	default:
+		out += (char)TAG_NULL;
+		break;
+	}
+}
+
+/**
+ * Reads a node and all its children.
+ * @param in Input stream.
+ * @param strings String table.
+ * @return YAML node.
+ */
+YAML::Node readNode(std::istream &in, const std::vector<std::string> &strings)
+{
+	int tag = in.get();
+	switch (tag)
+	{
+	case TAG_NULL:
+		return YAML::Node();
+	case TAG_SCALAR:
+		{
+			size_t index = readNumber(in);
+			if (index >= strings.size())
+			{
+				throw Exception("Binary save is corrupt");
+			}
+			return YAML::Node(strings[index]);
+		}
+	case TAG_SEQUENCE:
+		{
+			YAML::Node node(YAML::NodeType::Sequence);
+			for (size_t i = readNumber(in); i > 0; --i)
+			{
+				node.push_back(readNode(in, strings));
+			}
+			return node;
+		}
+	case TAG_MAP:
+		{
+			// keys were unique when written, so skip the lookup
+			// operator[] does on every insert
+			YAML::Node node(YAML::NodeType::Map);
+			for (size_t i = readNumber(in); i > 0; --i)
+			{
+				YAML::Node key = readNode(in, strings);
+				YAML::Node value = readNode(in, strings);
+				node.force_insert(key, value);
+			}
+			return node;
+		}
+	default:
+		throw Exception("Binary save is corrupt");
+	}
+}
+
+}
+
+/**
+ * Checks the stream starts with the binary save marker.
+ * The stream is left where it was.
+ * @param in Input stream.
+ * @return True if it's a binary save.
+ */
+bool isBinary(std::istream &in)
+{
+	char magic[sizeof(MAGIC)];
+	std::streampos start = in.tellg();
+	bool binary = in.read(magic, sizeof(MAGIC)) && std::equal(magic, magic + sizeof(MAGIC), MAGIC);
+	in.clear();
+	in.seekg(start);
+	return binary;
+}
+
+/**
+ * Writes out a list of YAML documents in binary.
+ * @param out Output stream, opened in binary mode.
+ * @param docs YAML documents.
+ */
+void save(std::ostream &out, const std::vector<YAML::Node> &docs)
+{
+	StringTable table;
+	std::vector<const std::string*> strings;
+	for (std::vector<YAML::Node>::const_iterator i = docs.begin(); i != docs.end(); ++i)
+	{
+		collectStrings(*i, table, strings);
+	}
+
+	std::string data(MAGIC, sizeof(MAGIC));
+	writeNumber(data, VERSION);
+	writeNumber(data, strings.size());
+	for (std::vector<const std::string*>::const_iterator i = strings.begin(); i != strings.end(); ++i)
+	{
+		writeNumber(data, (*i)->size());
+		data += **i;
+	}
+	writeNumber(data, docs.size());
+	for (std::vector<YAML::Node>::const_iterator i = docs.begin(); i != docs.end(); ++i)
+	{
+		writeNode(data, *i, table);
+	}
+	out.write(data.data(), data.size());
+}
+
+/**
+ * Reads back the YAML documents in a binary save.
+ * @param in Input stream, opened in binary mode.
+ * @param maxDocs Stop after this many documents (0 = all).
+ * @return YAML documents.
+ */
+std::vector<YAML::Node> load(std::istream &in, size_t maxDocs)
+{
+	if (!isBinary(in))
+	{
+		throw Exception("Not a binary save");
+	}
+	in.ignore(sizeof(MAGIC));
+	size_t version = readNumber(in);
+	if (version > (size_t)VERSION)
+	{
+		throw Exception("Binary save is from a newer version");
+	}
+
+	std::vector<std::string> strings(readNumber(in));
+	for (std::vector<std::string>::iterator i = strings.begin(); i != strings.end(); ++i)
+	{
+		i->resize(readNumber(in));
+		if (!i->empty() && !in.read(&(*i)[0], i->size()))
+		{
+			throw Exception("Binary save is corrupt");
+		}
+	}
+
+	std::vector<YAML::Node> docs;
+	size_t count = readNumber(in);
+	if (maxDocs != 0 && maxDocs < count)
+	{
+		count = maxDocs;
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		docs.push_back(readNode(in, strings));
+	}
+	return docs;
+}
+
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_BINARYSAVE_H
+#define OPENXCOM_BINARYSAVE_H
+
+#include <iostream>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Compact binary encoding of the YAML documents that make up a save,
+ * so saving and loading skip the YAML emitter and parser.
+ * Every object still saves to and loads from YAML nodes, this only
+ * replaces the text they're written as. Each distinct string is stored
+ * once in a table up front, then the nodes refer to it by index.
+ * Format: "OXCB", version, string table, document count, documents.
+ */
+namespace BinarySave
+{
+	/// Current version of the binary format.
+	const int VERSION = 1;
+	/// Checks if a stream holds a binary save.
+	bool isBinary(std::istream &in);
+	/// Writes documents to a binary save.
+	void save(std::ostream &out, const std::vector<YAML::Node> &docs);
+	/// Reads documents from a binary save.
+	std::vector<YAML::Node> load(std::istream &in, size_t maxDocs = 0);
+}
+
+}
+
+#endif
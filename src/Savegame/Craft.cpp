@@ -48,7 +48,7 @@ namespace OpenXcom
  */
 Craft::Craft(RuleCraft *rules, Base *base, int id) : MovingTarget(), _rules(rules), _base(base), _id(0), _fuel(0), _damage(0), _interceptionOrder(0), _weapons(), _status("STR_READY"), _lowFuel(false), _inBattlescape(false), _inDogfight(false), _name(L"")
 {
-	_items = new ItemContainer();
+	_items = new ItemContainer(base->getRuleset());
 	if (id != 0)
 	{
 		_id = id;
@@ -163,17 +163,6 @@ void Craft::load(const YAML::Node &node, const Ruleset *rule, SavedGame *save)
 	}
 
 	_items->load(node["items"]);
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end();)
-	{
-		if (std::find(rule->getItemsList().begin(), rule->getItemsList().end(), i->first) == rule->getItemsList().end())
-		{
-			_items->getContents()->erase(i++);
-		}
-		else
-		{
-			++i;
-		}
-	}
 	for (YAML::const_iterator i = node["vehicles"].begin(); i != node["vehicles"].end(); ++i)
 	{
 		std::string type = (*i)["type"].as<std::string>();
@@ -25,8 +25,9 @@ namespace OpenXcom
 
 /**
  * Initializes an item container with no contents.
+ * @param rule Pointer to the ruleset with the items.
  */
-ItemContainer::ItemContainer() : _qty()
+ItemContainer::ItemContainer(const Ruleset *rule) : _rule(rule), _qty(rule->getItemsList().size(), 0)
 {
 }
 
@@ -39,11 +40,21 @@ ItemContainer::~ItemContainer()
 
 /**
  * Loads the item container from a YAML file.
+ * Items that aren't in the ruleset are left out,
+ * some old saves have bad items.
  * @param node YAML node.
  */
 void ItemContainer::load(const YAML::Node &node)
 {
-	_qty = node.as< std::map<std::string, int> >(_qty);
+	std::map<std::string, int> items = node.as< std::map<std::string, int> >(std::map<std::string, int>());
+	for (std::map<std::string, int>::const_iterator i = items.begin(); i != items.end(); ++i)
+	{
+		int *qty = getEntry(_rule->getItem(i->first));
+		if (qty != 0)
+		{
+			*qty = i->second;
+		}
+	}
 }
 
 /**
@@ -53,10 +64,24 @@ void ItemContainer::load(const YAML::Node &node)
 YAML::Node ItemContainer::save() const
 {
 	YAML::Node node;
-	node = _qty;
+	node = getContents();
 	return node;
 }
 
+/**
+ * Returns the quantity stored for an item, so it can be changed.
+ * @param item Item rules.
+ * @return Pointer to the quantity, or 0 if the item isn't in the ruleset.
+ */
+int *ItemContainer::getEntry(const RuleItem *item)
+{
+	if (item == 0 || item->getIndex() < 0 || item->getIndex() >= (int)_qty.size())
+	{
+		return 0;
+	}
+	return &_qty[item->getIndex()];
+}
+
 /**
  * Adds an item amount to the container.
  * @param id Item ID.
@@ -68,11 +93,21 @@ void ItemContainer::addItem(const std::string &id, int qty)
 	{
 		return;
 	}
-	if (_qty.find(id) == _qty.end())
+	addItem(_rule->getItem(id), qty);
+}
+
+/**
+ * Adds an item amount to the container.
+ * @param item Item rules.
+ * @param qty Item quantity.
+ */
+void ItemContainer::addItem(const RuleItem *item, int qty)
+{
+	int *entry = getEntry(item);
+	if (entry != 0)
 	{
-		_qty[id] = 0;
+		*entry += qty;
 	}
-	_qty[id] += qty;
 }
 
 /**
@@ -82,17 +117,32 @@ void ItemContainer::addItem(const std::string &id, int qty)
  */
 void ItemContainer::removeItem(const std::string &id, int qty)
 {
-	if (id.empty() || _qty.find(id) == _qty.end())
+	if (id.empty())
 	{
 		return;
 	}
-	if (qty < _qty[id])
+	removeItem(_rule->getItem(id), qty);
+}
+
+/**
+ * Removes an item amount from the container.
+ * @param item Item rules.
+ * @param qty Item quantity.
+ */
+void ItemContainer::removeItem(const RuleItem *item, int qty)
+{
+	int *entry = getEntry(item);
+	if (entry == 0)
 	{
-		_qty[id] -= qty;
+		return;
+	}
+	if (qty < *entry)
+	{
+		*entry -= qty;
 	}
 	else
 	{
-		_qty.erase(id);
+		*entry = 0;
 	}
 }
 
@@ -107,16 +157,21 @@ int ItemContainer::getItem(const std::string &id) const
 	{
 		return 0;
 	}
+	return getItem(_rule->getItem(id));
+}
 
-	std::map<std::string, int>::const_iterator it = _qty.find(id);
-	if (it == _qty.end())
+/**
+ * Returns the quantity of an item in the container.
+ * @param item Item rules.
+ * @return Item quantity.
+ */
+int ItemContainer::getItem(const RuleItem *item) const
+{
+	if (item == 0 || item->getIndex() < 0 || item->getIndex() >= (int)_qty.size())
 	{
 		return 0;
 	}
-	else
-	{
-		return it->second;
-	}
+	return _qty[item->getIndex()];
 }
 
 /**
@@ -126,35 +181,88 @@ int ItemContainer::getItem(const std::string &id) const
 int ItemContainer::getTotalQuantity() const
 {
 	int total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	for (std::vector<int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
 	{
-		total += i->second;
+		total += *i;
 	}
 	return total;
 }
 
 /**
  * Returns the total size of the items in the container.
- * @param rule Pointer to ruleset.
  * @return Total item size.
  */
-double ItemContainer::getTotalSize(const Ruleset *rule) const
+double ItemContainer::getTotalSize() const
 {
 	double total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	for (size_t i = 0; i < _qty.size(); ++i)
+	{
+		if (_qty[i] != 0)
+		{
+			total += _rule->getItemByIndex(i)->getSize() * _qty[i];
+		}
+	}
+	return total;
+}
+
+/**
+ * Returns the total quantity of the live aliens in the container.
+ * @return Total alien quantity.
+ */
+int ItemContainer::getTotalAliens() const
+{
+	int total = 0;
+	for (size_t i = 0; i < _qty.size(); ++i)
 	{
-		total += rule->getItem(i->first)->getSize() * i->second;
+		if (_qty[i] != 0 && _rule->getItemByIndex(i)->getAlien())
+		{
+			total += _qty[i];
+		}
 	}
 	return total;
 }
 
 /**
- * Returns all the items currently contained within.
+ * Checks if there are no items in the container.
+ * @return True if it's empty.
+ */
+bool ItemContainer::isEmpty() const
+{
+	for (std::vector<int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	{
+		if (*i != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Removes all the items from the container.
+ */
+void ItemContainer::clear()
+{
+	_qty.assign(_qty.size(), 0);
+}
+
+/**
+ * Returns all the items currently contained within,
+ * by name. The list is a copy, so the container can
+ * be changed while going through it.
  * @return List of contents.
  */
-std::map<std::string, int> *ItemContainer::getContents()
+std::map<std::string, int> ItemContainer::getContents() const
 {
-	return &_qty;
+	std::map<std::string, int> contents;
+	for (size_t i = 0; i < _qty.size(); ++i)
+	{
+		if (_qty[i] != 0)
+		{
+			contents[_rule->getItemByIndex(i)->getType()] = _qty[i];
+		}
+	}
+	return contents;
 }
 
 }
@@ -20,6 +20,7 @@
 #define OPENXCOM_ITEMCONTAINER_H
 
 #include <string>
+#include <vector>
 #include <map>
 #include <yaml-cpp/yaml.h>
 
@@ -27,19 +28,27 @@ namespace OpenXcom
 {
 
 class Ruleset;
+class RuleItem;
 
 /**
  * Represents the items contained by a certain entity,
  * like base stores, craft equipment, etc.
  * Handles all necessary item management tasks.
+ * Quantities are kept in a table indexed by the item
+ * numbers of the ruleset, names are only used to look
+ * items up and to load and save them.
  */
 class ItemContainer
 {
 private:
-	std::map<std::string, int> _qty;
+	const Ruleset *_rule;
+	std::vector<int> _qty;
+
+	/// Gets the table entry of an item, if it has one.
+	int *getEntry(const RuleItem *item);
 public:
 	/// Creates an empty item container.
-	ItemContainer();
+	ItemContainer(const Ruleset *rule);
 	/// Cleans up the item container.
 	~ItemContainer();
 	/// Loads the item container from YAML.
@@ -48,16 +57,28 @@ public:
 	YAML::Node save() const;
 	/// Adds an item to the container.
 	void addItem(const std::string &id, int qty = 1);
+	/// Adds an item to the container.
+	void addItem(const RuleItem *item, int qty = 1);
 	/// Removes an item from the container.
 	void removeItem(const std::string &id, int qty = 1);
+	/// Removes an item from the container.
+	void removeItem(const RuleItem *item, int qty = 1);
 	/// Gets an item in the container.
 	int getItem(const std::string &id) const;
+	/// Gets an item in the container.
+	int getItem(const RuleItem *item) const;
 	/// Gets the total quantity of items in the container.
 	int getTotalQuantity() const;
 	/// Gets the total size of items in the container.
-	double getTotalSize(const Ruleset *rule) const;
+	double getTotalSize() const;
+	/// Gets the total quantity of live aliens in the container.
+	int getTotalAliens() const;
+	/// Checks if the container is empty.
+	bool isEmpty() const;
+	/// Removes all the items from the container.
+	void clear();
 	/// Gets all the items in the container.
-	std::map<std::string, int> *getContents();
+	std::map<std::string, int> getContents() const;
 };
 
 }
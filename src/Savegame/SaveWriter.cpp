@@ -0,0 +1,235 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SaveWriter.h"
+#include <fstream>
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Starts the writer thread. If it can't be started,
+ * saves are written straight away instead.
+ */
+SaveWriter::SaveWriter() : _nextJob(0), _writing(false), _quit(false)
+{
+	_mutex = SDL_CreateMutex();
+	_wake = SDL_CreateCond();
+	_done = SDL_CreateCond();
+	_thread = SDL_CreateThread(worker, (void*)this);
+	if (_thread == 0)
+	{
+		Log(LOG_WARNING) << "Failed to start save thread: " << SDL_GetError();
+	}
+}
+
+/**
+ * Waits for the pending saves so none are lost,
+ * then stops the writer thread.
+ */
+SaveWriter::~SaveWriter()
+{
+	if (_thread != 0)
+	{
+		SDL_LockMutex(_mutex);
+		_quit = true;
+		SDL_CondSignal(_wake);
+		SDL_UnlockMutex(_mutex);
+		SDL_WaitThread(_thread, 0);
+	}
+	SDL_DestroyCond(_done);
+	SDL_DestroyCond(_wake);
+	SDL_DestroyMutex(_mutex);
+}
+
+/**
+ * Writes out queued saves until told to quit
+ * and there's nothing left.
+ * @param writer Pointer to the save writer.
+ * @return Thread exit code.
+ */
+int SaveWriter::worker(void *writer)
+{
+	SaveWriter *self = (SaveWriter*)writer;
+	SDL_LockMutex(self->_mutex);
+	while (true)
+	{
+		while (!self->_quit && self->_jobs.empty())
+		{
+			SDL_CondWait(self->_wake, self->_mutex);
+		}
+		if (self->_jobs.empty())
+		{
+			break;
+		}
+		Job job = self->_jobs.front();
+		self->_jobs.pop_front();
+		self->_writing = true;
+		SDL_UnlockMutex(self->_mutex);
+
+		std::string error;
+		bool ok = write(job, &error);
+
+		SDL_LockMutex(self->_mutex);
+		if (!ok)
+		{
+			Log(LOG_ERROR) << error;
+			self->_errors.push_back(std::make_pair(job.id, error));
+		}
+		self->_writing = false;
+		SDL_CondBroadcast(self->_done);
+	}
+	SDL_UnlockMutex(self->_mutex);
+	return 0;
+}
+
+/**
+ * Writes a save to its backup file, then replaces the
+ * save with it, so a failed write never wipes out the old one.
+ * @param job Save to write.
+ * @param error Gets the error message if it fails.
+ * @return True if the save was written.
+ */
+bool SaveWriter::write(const Job &job, std::string *error)
+{
+	std::ofstream sav(job.backupPath.c_str(), std::ios::out | std::ios::binary);
+	if (!sav)
+	{
+		*error = "Failed to save " + job.filename;
+		return false;
+	}
+	sav.write(job.data.data(), job.data.size());
+	sav.close();
+	if (!sav)
+	{
+		*error = "Failed to save " + job.filename;
+		return false;
+	}
+	if (!CrossPlatform::moveFile(job.backupPath, job.path))
+	{
+		*error = "Save backed up in " + job.filename + ".bak";
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Hands a serialized save to the writer thread.
+ * @param filename Save filename.
+ * @param data Serialized save contents.
+ * @return Job number, to look up this save's error with.
+ */
+int SaveWriter::save(const std::string &filename, const std::string &data)
+{
+	Job job;
+	job.id = _nextJob++;
+	job.filename = filename;
+	job.path = Options::getUserFolder() + filename;
+	job.backupPath = job.path + ".bak";
+	job.data = data;
+	if (_thread == 0)
+	{
+		std::string error;
+		if (!write(job, &error))
+		{
+			Log(LOG_ERROR) << error;
+			_errors.push_back(std::make_pair(job.id, error));
+		}
+		return job.id;
+	}
+	SDL_LockMutex(_mutex);
+	_jobs.push_back(job);
+	SDL_CondSignal(_wake);
+	SDL_UnlockMutex(_mutex);
+	return job.id;
+}
+
+/**
+ * Checks if any saves are still queued up or being written.
+ * @return True if the writer is busy.
+ */
+bool SaveWriter::isBusy()
+{
+	SDL_LockMutex(_mutex);
+	bool busy = _writing || !_jobs.empty();
+	SDL_UnlockMutex(_mutex);
+	return busy;
+}
+
+/**
+ * Blocks until every queued save is written,
+ * eg. before loading one of them back.
+ */
+void SaveWriter::wait()
+{
+	SDL_LockMutex(_mutex);
+	while (_writing || !_jobs.empty())
+	{
+		SDL_CondWait(_done, _mutex);
+	}
+	SDL_UnlockMutex(_mutex);
+}
+
+/**
+ * Gets the oldest error from saves that failed
+ * to be written, so it can be shown to the player.
+ * @param error Gets the error message.
+ * @return True if there was an error.
+ */
+bool SaveWriter::getError(std::string *error)
+{
+	SDL_LockMutex(_mutex);
+	bool found = !_errors.empty();
+	if (found)
+	{
+		*error = _errors.front().second;
+		_errors.erase(_errors.begin());
+	}
+	SDL_UnlockMutex(_mutex);
+	return found;
+}
+
+/**
+ * Gets the error from a specific save, leaving the errors
+ * of any other saves to be reported on their own.
+ * @param job Job number returned when the save was queued.
+ * @param error Gets the error message.
+ * @return True if that save failed.
+ */
+bool SaveWriter::getError(int job, std::string *error)
+{
+	SDL_LockMutex(_mutex);
+	bool found = false;
+	for (std::vector<std::pair<int, std::string> >::iterator i = _errors.begin(); i != _errors.end(); ++i)
+	{
+		if (i->first == job)
+		{
+			*error = i->second;
+			_errors.erase(i);
+			found = true;
+			break;
+		}
+	}
+	SDL_UnlockMutex(_mutex);
+	return found;
+}
+
+}
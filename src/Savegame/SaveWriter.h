@@ -0,0 +1,78 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_SAVEWRITER_H
+#define OPENXCOM_SAVEWRITER_H
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+#include <SDL.h>
+#include <SDL_thread.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Writes save files out on a background thread, so the
+ * game doesn't stall while the disk catches up.
+ * Saves are serialized on the main thread beforehand,
+ * then written to a backup file and renamed over the old
+ * save once complete, in the order they were handed in.
+ */
+class SaveWriter
+{
+private:
+	/// A save waiting to be written.
+	struct Job
+	{
+		int id;
+		std::string filename, path, backupPath, data;
+	};
+	std::deque<Job> _jobs;
+	std::vector<std::pair<int, std::string> > _errors;
+	int _nextJob;
+	SDL_Thread *_thread;
+	SDL_mutex *_mutex;
+	SDL_cond *_wake, *_done;
+	bool _writing, _quit;
+	/// Entry point of the writer thread.
+	static int worker(void *writer);
+	/// Writes out a save file.
+	static bool write(const Job &job, std::string *error);
+public:
+	/// Creates the save writer and its thread.
+	SaveWriter();
+	/// Finishes the pending saves and stops the thread.
+	~SaveWriter();
+	/// Queues up a save to be written.
+	int save(const std::string &filename, const std::string &data);
+	/// Checks if there are saves still being written.
+	bool isBusy();
+	/// Waits for all the pending saves to be written.
+	void wait();
+	/// Gets the next error from saves that failed.
+	bool getError(std::string *error);
+	/// Gets the error from a specific save, if it failed.
+	bool getError(int job, std::string *error);
+};
+
+}
+
+#endif
@@ -1335,7 +1335,9 @@ void SavedBattleGame::prepareNewTurn()
 				getTiles()[i]->prepareNewTurn();
 		}
 		// fires could have been started, stopped or smoke could reveal/conceal units.
-		getTileEngine()->calculateTerrainLighting();
+		// that happens all over the map, so redo everyone's FOV rather than an area.
+		getTileEngine()->updateTerrainLighting(Position(0, 0, 0));
+		getTileEngine()->recalculateFOV();
 	}
 
 	reviveUnconsciousUnits();
@@ -1746,4 +1748,14 @@ SavedGame *SavedBattleGame::getGeoscapeSave()
 {
 	return _battleState->getGame()->getSavedGame();
 }
+
+/**
+ * Gets the light sources currently lighting up the terrain.
+ * These are maintained by the TileEngine.
+ * @return Pointer to the map of light sources, keyed by tile index.
+ */
+std::map<int, LightSource> *SavedBattleGame::getLightSources()
+{
+	return &_lightSources;
+}
 }
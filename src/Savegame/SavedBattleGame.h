@@ -22,6 +22,7 @@
 #include <iostream>
 #include <algorithm>
 #include <vector>
+#include <map>
 #include <string>
 #include <SDL.h>
 #include <yaml-cpp/yaml.h>
@@ -42,6 +43,18 @@ class TileEngine;
 class BattleItem;
 class Ruleset;
 
+/**
+ * A terrain light source registered on the map: the brightest of
+ * a tile's floor, object, fire and flare lights, along with every
+ * tile it lit, so its contribution can be taken back later.
+ */
+struct LightSource
+{
+	Position position;
+	int power;
+	std::vector<int> litTiles;
+};
+
 /**
  * The battlescape data that gets written to disk when the game is saved.
  * A saved game holds all the variable info in a game like mapdata,
@@ -75,6 +88,7 @@ private:
 	BattleActionType _tuReserved;
 	bool _kneelReserved;
 	std::vector< std::vector<std::pair<int, int> > > _baseModules;
+	std::map<int, LightSource> _lightSources;
 	/// Selects a soldier.
 	BattleUnit *selectPlayerUnit(int dir, bool checkReselect = false, bool setReselect = false, bool checkInventory = false);
 public:
@@ -245,6 +259,8 @@ public:
 	std::vector< std::vector<std::pair<int, int> > > &getModuleMap();
 	/// calculate the number of map modules remaining
 	void calculateModuleMap();
+	/// Gets the terrain light sources, keyed by tile index.
+	std::map<int, LightSource> *getLightSources();
 	/// a shortcut to the geoscape save.
 	SavedGame *getGeoscapeSave();
 
@@ -49,6 +49,7 @@
 #include "AlienBase.h"
 #include "AlienStrategy.h"
 #include "AlienMission.h"
+#include "BinarySave.h"
 #include "../Ruleset/RuleRegion.h"
 
 namespace OpenXcom
@@ -213,7 +214,7 @@ std::vector<SaveInfo> SavedGame::getList(Language *lang, bool autoquick)
 SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
 {
 	std::string fullname = Options::getUserFolder() + file;
-	YAML::Node doc = YAML::LoadFile(fullname);
+	YAML::Node doc = loadDocuments(fullname, 1).front();
 	SaveInfo save;
 
 	save.fileName = file;
@@ -280,16 +281,59 @@ SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
 }
 
 /**
- * Loads a saved game's contents from a YAML file.
+ * Reads the YAML documents in a save file,
+ * whichever format it's in.
+ * @param path Full path to the save.
+ * @param maxDocs Stop after this many documents (0 = all).
+ * @return YAML documents.
+ */
+std::vector<YAML::Node> SavedGame::loadDocuments(const std::string &path, size_t maxDocs)
+{
+	std::ifstream sav(path.c_str(), std::ios::in | std::ios::binary);
+	if (!sav)
+	{
+		throw Exception(path + " not found");
+	}
+	std::vector<YAML::Node> docs;
+	if (BinarySave::isBinary(sav))
+	{
+		docs = BinarySave::load(sav, maxDocs);
+	}
+	else if (maxDocs == 1)
+	{
+		// only parse the brief, not the whole game that follows it
+		YAML::Node brief = YAML::Load(sav);
+		if (!brief.IsNull())
+		{
+			docs.push_back(brief);
+		}
+	}
+	else
+	{
+		docs = YAML::LoadAll(sav);
+		if (maxDocs != 0 && docs.size() > maxDocs)
+		{
+			docs.resize(maxDocs);
+		}
+	}
+	if (docs.empty())
+	{
+		throw Exception(path + " is not a vaild save file");
+	}
+	return docs;
+}
+
+/**
+ * Loads a saved game's contents from a YAML or binary file.
  * @note Assumes the saved game is blank.
- * @param filename YAML filename.
+ * @param filename Save filename.
  * @param rule Ruleset for the saved game.
  */
 void SavedGame::load(const std::string &filename, Ruleset *rule)
 {
 	std::string s = Options::getUserFolder() + filename;
-	std::vector<YAML::Node> file = YAML::LoadAllFromFile(s);
-	if (file.empty())
+	std::vector<YAML::Node> file = loadDocuments(s);
+	if (file.size() < 2)
 	{
 		throw Exception(filename + " is not a vaild save file");
 	}
@@ -412,7 +456,7 @@ void SavedGame::load(const std::string &filename, Ruleset *rule)
 		std::string research = it->as<std::string>();
 		if (rule->getResearch(research))
 		{
-			_discovered.push_back(rule->getResearch(research));
+			addDiscovered(rule->getResearch(research));
 		}
 	}
 	
@@ -442,20 +486,51 @@ void SavedGame::load(const std::string &filename, Ruleset *rule)
 }
 
 /**
- * Saves a saved game's contents to a YAML file.
- * @param filename YAML filename.
+ * Saves a saved game's contents to a file,
+ * in the format set in the options.
+ * @param filename Save filename.
  */
 void SavedGame::save(const std::string &filename) const
+{
+	save(filename, Options::binarySaves ? SAVE_FORMAT_BINARY : SAVE_FORMAT_YAML);
+}
+
+/**
+ * Saves a saved game's contents to a file.
+ * @param filename Save filename.
+ * @param format YAML (readable) or binary (fast).
+ */
+void SavedGame::save(const std::string &filename, SaveFormat format) const
 {
 	std::string s = Options::getUserFolder() + filename;
-	std::ofstream sav(s.c_str());
+	std::ofstream sav(s.c_str(), std::ios::out | std::ios::binary);
 	if (!sav)
 	{
 		throw Exception("Failed to save " + filename);
 	}
+	std::string data = serialize(format);
+	sav.write(data.data(), data.size());
+	sav.close();
+}
 
-	YAML::Emitter out;
+/**
+ * Converts a saved game's contents into what gets written
+ * to the save file, in the format set in the options.
+ * @return Save file contents.
+ */
+std::string SavedGame::serialize() const
+{
+	return serialize(Options::binarySaves ? SAVE_FORMAT_BINARY : SAVE_FORMAT_YAML);
+}
 
+/**
+ * Converts a saved game's contents into what gets written
+ * to the save file, so it can be written out later.
+ * @param format YAML (readable) or binary (fast).
+ * @return Save file contents.
+ */
+std::string SavedGame::serialize(SaveFormat format) const
+{
 	// Saves the brief game info used in the saves list
 	YAML::Node brief;
 	brief["name"] = Language::wstrToUtf8(_name);
@@ -470,9 +545,7 @@ void SavedGame::save(const std::string &filename) const
 	brief["rulesets"] = Options::rulesets;
 	if (_ironman)
 		brief["ironman"] = _ironman;
-	out << brief;
 	// Saves the full game data to the save
-	out << YAML::BeginDoc;
 	YAML::Node node;
 	node["difficulty"] = (int)_difficulty;
 	node["monthsPassed"] = _monthsPassed;
@@ -542,9 +615,23 @@ void SavedGame::save(const std::string &filename) const
 	{
 		node["battleGame"] = _battleGame->save();
 	}
-	out << node;
-	sav << out.c_str();
-	sav.close();
+	if (format == SAVE_FORMAT_BINARY)
+	{
+		std::vector<YAML::Node> docs;
+		docs.push_back(brief);
+		docs.push_back(node);
+		std::ostringstream out;
+		BinarySave::save(out, docs);
+		return out.str();
+	}
+	else
+	{
+		YAML::Emitter out;
+		out << brief;
+		out << YAML::BeginDoc;
+		out << node;
+		return out.c_str();
+	}
 }
 
 /**
@@ -898,10 +985,9 @@ void SavedGame::setBattleGame(SavedBattleGame *battleGame)
 */
 void SavedGame::addFinishedResearch (const RuleResearch * r, const Ruleset * ruleset)
 {
-	std::vector<const RuleResearch *>::const_iterator itDiscovered = std::find(_discovered.begin (), _discovered.end (), r);
-	if(itDiscovered == _discovered.end())
+	if(!isDiscovered(r))
 	{
-		_discovered.push_back(r);
+		addDiscovered(r);
 		removePoppedResearch(r);
 		addResearchScore(r->getPoints());
 	}
@@ -969,11 +1055,9 @@ void SavedGame::getAvailableResearchProjects (std::vector<RuleResearch *> & proj
 		{
 			continue;
 		}
-		std::vector<const RuleResearch *>::const_iterator itDiscovered = std::find(discovered.begin (), discovered.end (), research);
-		
 		bool liveAlien = ruleset->getUnit(research->getName()) != 0;
 
-		if (itDiscovered != discovered.end ())
+		if (isDiscovered(research))
 		{
 			if (!liveAlien)
 			{
@@ -986,8 +1070,7 @@ void SavedGame::getAvailableResearchProjects (std::vector<RuleResearch *> & proj
 				{
 					for (std::vector<std::string>::const_iterator ohBoy = research->getGetOneFree().begin(); ohBoy != research->getGetOneFree().end(); ++ohBoy)
 					{
-						std::vector<const RuleResearch *>::const_iterator more_iteration = std::find(discovered.begin (), discovered.end (), ruleset->getResearch(*ohBoy));
-						if (more_iteration == discovered.end ())
+						if (!isDiscovered(ruleset->getResearch(*ohBoy)))
 						{
 							cull = false;
 							break;
@@ -1002,15 +1085,13 @@ void SavedGame::getAvailableResearchProjects (std::vector<RuleResearch *> & proj
 
 				if (leader)
 				{
-					std::vector<const RuleResearch*>::const_iterator found = std::find(discovered.begin(), discovered.end(), ruleset->getResearch("STR_LEADER_PLUS"));
-					if (found == discovered.end())
+					if (!isDiscovered(ruleset->getResearch("STR_LEADER_PLUS")))
 						cull = false;
 				}
 
 				if (cmnder)
 				{
-					std::vector<const RuleResearch*>::const_iterator found = std::find(discovered.begin(), discovered.end(), ruleset->getResearch("STR_CYDONIA_DEP"));
-					if (found == discovered.end())
+					if (!isDiscovered(ruleset->getResearch("STR_CYDONIA_DEP")))
 						cull = false;
 				}
 
@@ -1032,8 +1113,7 @@ void SavedGame::getAvailableResearchProjects (std::vector<RuleResearch *> & proj
 			size_t tally(0);
 			for(size_t itreq = 0; itreq != research->getRequirements().size(); ++itreq)
 			{
-				itDiscovered = std::find(discovered.begin (), discovered.end (), ruleset->getResearch(research->getRequirements().at(itreq)));
-				if (itDiscovered != discovered.end ())
+				if (isDiscovered(ruleset->getResearch(research->getRequirements().at(itreq))))
 				{
 					tally++;
 				}
@@ -1082,7 +1162,6 @@ void SavedGame::getAvailableProductions (std::vector<RuleManufacture *> & produc
 bool SavedGame::isResearchAvailable (RuleResearch * r, const std::vector<const RuleResearch *> & unlocked, const Ruleset * ruleset) const
 {
 	std::vector<std::string> deps = r->getDependencies();
-	const std::vector<const RuleResearch *> & discovered(getDiscoveredResearch());
 	bool liveAlien = ruleset->getUnit(r->getName()) != 0;
 	if(std::find(unlocked.begin (), unlocked.end (), r) != unlocked.end ())
 	{
@@ -1107,15 +1186,13 @@ bool SavedGame::isResearchAvailable (RuleResearch * r, const std::vector<const R
 
 			if (leader)
 			{
-				std::vector<const RuleResearch*>::const_iterator found = std::find(discovered.begin(), discovered.end(), ruleset->getResearch("STR_LEADER_PLUS"));
-				if (found == discovered.end())
+				if (!isDiscovered(ruleset->getResearch("STR_LEADER_PLUS")))
 					return true;
 			}
 
 			if (cmnder)
 			{
-				std::vector<const RuleResearch*>::const_iterator found = std::find(discovered.begin(), discovered.end(), ruleset->getResearch("STR_CYDONIA_DEP"));
-				if (found == discovered.end())
+				if (!isDiscovered(ruleset->getResearch("STR_CYDONIA_DEP")))
 					return true;
 			}
 		}
@@ -1123,9 +1200,7 @@ bool SavedGame::isResearchAvailable (RuleResearch * r, const std::vector<const R
 
 	for(std::vector<std::string>::const_iterator iter = deps.begin (); iter != deps.end (); ++ iter)
 	{
-		RuleResearch *research = ruleset->getResearch(*iter);
-		std::vector<const RuleResearch *>::const_iterator itDiscovered = std::find(discovered.begin (), discovered.end (), research);
-		if (itDiscovered == discovered.end ())
+		if (!isDiscovered(ruleset->getResearch(*iter)))
 		{
 			return false;
 		}
@@ -1247,6 +1322,41 @@ bool SavedGame::isResearched(const std::vector<std::string> &research) const
 	return false;
 }
 
+/**
+ * Returns if a certain research has been discovered,
+ * without going through the whole list of discoveries.
+ * @param research Pointer to the research rule.
+ * @return Whether it's been discovered or not.
+ */
+bool SavedGame::isDiscovered(const RuleResearch *research) const
+{
+	if (research == 0)
+		return false;
+	int index = research->getIndex();
+	if (index < 0)
+		return std::find(_discovered.begin(), _discovered.end(), research) != _discovered.end();
+	return (size_t)index < _discoveredIndex.size() && _discoveredIndex[index];
+}
+
+/**
+ * Adds a research to the discoveries, keeping
+ * track of it by its number too.
+ * @param research Pointer to the research rule.
+ */
+void SavedGame::addDiscovered(const RuleResearch *research)
+{
+	_discovered.push_back(research);
+	int index = research->getIndex();
+	if (index >= 0)
+	{
+		if ((size_t)index >= _discoveredIndex.size())
+		{
+			_discoveredIndex.resize(index + 1, false);
+		}
+		_discoveredIndex[index] = true;
+	}
+}
+
 /**
  * Returns pointer to the Soldier given it's unique ID.
  * @param id A soldier's unique id.
@@ -1542,6 +1652,52 @@ Region *SavedGame::locateRegion(double lon, double lat) const
 	return 0;
 }
 
+/**
+ * Find the region containing this location, using
+ * the ruleset's lookup grid instead of checking them all.
+ * Overlapping regions are resolved in ruleset order,
+ * not in the order of the saved game's list.
+ * @param rule Pointer to the ruleset.
+ * @param lon The longtitude.
+ * @param lat The latitude.
+ * @return Pointer to the region, or 0.
+ */
+Region *SavedGame::locateRegion(const Ruleset *rule, double lon, double lat) const
+{
+	RuleRegion *found = rule->locateRegion(lon, lat);
+	for (std::vector<Region*>::const_iterator i = _regions.begin(); found != 0 && i != _regions.end(); ++i)
+	{
+		if ((*i)->getRules() == found)
+		{
+			return *i;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Find the country containing this location, using
+ * the ruleset's lookup grid instead of checking them all.
+ * Overlapping countries are resolved in ruleset order,
+ * not in the order of the saved game's list.
+ * @param rule Pointer to the ruleset.
+ * @param lon The longtitude.
+ * @param lat The latitude.
+ * @return Pointer to the country, or 0.
+ */
+Country *SavedGame::locateCountry(const Ruleset *rule, double lon, double lat) const
+{
+	RuleCountry *found = rule->locateCountry(lon, lat);
+	for (std::vector<Country*>::const_iterator i = _countries.begin(); found != 0 && i != _countries.end(); ++i)
+	{
+		if ((*i)->getRules() == found)
+		{
+			return *i;
+		}
+	}
+	return 0;
+}
+
 /**
  * Find the region containing this target.
  * @param target The target to locate.
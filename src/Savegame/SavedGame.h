@@ -23,6 +23,7 @@
 #include <vector>
 #include <string>
 #include <time.h>
+#include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
 {
@@ -58,6 +59,12 @@ enum GameDifficulty { DIFF_BEGINNER = 0, DIFF_EXPERIENCED, DIFF_VETERAN, DIFF_GE
  */
 enum SaveType { SAVE_DEFAULT, SAVE_QUICK, SAVE_AUTO_GEOSCAPE, SAVE_AUTO_BATTLESCAPE, SAVE_IRONMAN, SAVE_IRONMAN_END };
 
+/**
+ * File formats a game can be saved in.
+ * Loading works with either.
+ */
+enum SaveFormat { SAVE_FORMAT_YAML, SAVE_FORMAT_BINARY };
+
 /**
  * Container for savegame info displayed on listings.
  */
@@ -98,6 +105,7 @@ private:
 	AlienStrategy *_alienStrategy;
 	SavedBattleGame *_battleGame;
 	std::vector<const RuleResearch *> _discovered;
+	std::vector<bool> _discoveredIndex;
 	std::vector<AlienMission*> _activeMissions;
 	bool _debug, _warned;
 	int _monthsPassed;
@@ -109,7 +117,9 @@ private:
 	int _selectedBase;
 
 	void getDependableResearchBasic (std::vector<RuleResearch *> & dependables, const RuleResearch *research, const Ruleset * ruleset, Base * base) const;
+	void addDiscovered(const RuleResearch *research);
 	static SaveInfo getSaveInfo(const std::string &file, Language *lang);
+	static std::vector<YAML::Node> loadDocuments(const std::string &path, size_t maxDocs = 0);
 public:
 	static const std::string AUTOSAVE_GEOSCAPE, AUTOSAVE_BATTLESCAPE, QUICKSAVE;
 
@@ -119,10 +129,16 @@ public:
 	~SavedGame();
 	/// Gets list of saves in the user directory.
 	static std::vector<SaveInfo> getList(Language *lang, bool autoquick);
-	/// Loads a saved game from YAML.
+	/// Loads a saved game from YAML or binary.
 	void load(const std::string &filename, Ruleset *rule);
-	/// Saves a saved game to YAML.
+	/// Saves a saved game in the format set in the options.
 	void save(const std::string &filename) const;
+	/// Saves a saved game in a specific format.
+	void save(const std::string &filename, SaveFormat format) const;
+	/// Gets the save file contents in the format set in the options.
+	std::string serialize() const;
+	/// Gets the save file contents in a specific format.
+	std::string serialize(SaveFormat format) const;
 	/// Gets the game name.
 	std::wstring getName() const;
 	/// Sets the game name.
@@ -201,6 +217,8 @@ public:
 	bool isResearched(const std::string &research) const;
 	/// Gets if a list of research has been unlocked.
 	bool isResearched(const std::vector<std::string> &research) const;
+	/// Checks if a research has been discovered.
+	bool isDiscovered(const RuleResearch *research) const;
 	/// Gets the soldier matching this ID.
 	Soldier *getSoldier(int id) const;
 	/// Handles the higher promotions.
@@ -241,6 +259,10 @@ public:
 	Region *locateRegion(double lon, double lat) const;
 	/// Locate a region containing a Target.
 	Region *locateRegion(const Target &target) const;
+	/// Locate a region containing a position, with the ruleset's lookup grid.
+	Region *locateRegion(const Ruleset *rule, double lon, double lat) const;
+	/// Locate a country containing a position, with the ruleset's lookup grid.
+	Country *locateCountry(const Ruleset *rule, double lon, double lat) const;
 	/// Return the month counter.
 	int getMonthsPassed() const;
 	/// Return the GraphRegionToggles.
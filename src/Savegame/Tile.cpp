@@ -43,11 +43,13 @@ Tile::SerializationKey Tile::serializationKey =
  4 + 2*4 + 2*4 + 1 + 1 + 1 // total bytes to save one tile
 };
 
+int Tile::_mapGeneration = 0;
+
 /**
 * constructor
 * @param pos Position.
 */
-Tile::Tile(const Position& pos): _smoke(0), _fire(0), _explosive(0), _pos(pos), _unit(0), _animationOffset(0), _markerColor(0), _visible(false), _preview(-1), _TUMarker(0), _overlaps(0), _danger(false)
+Tile::Tile(const Position& pos): _smoke(0), _fire(0), _explosive(0), _pos(pos), _unit(0), _animationOffset(0), _markerColor(0), _visible(false), _preview(-1), _TUMarker(0), _overlaps(0), _danger(false), _terrainVersion(0)
 {
 	for (int i = 0; i < 4; ++i)
 	{
@@ -199,6 +201,8 @@ void Tile::setMapData(MapData *dat, int mapDataID, int mapDataSetID, int part)
 	_objects[part] = dat;
 	_mapDataID[part] = mapDataID;
 	_mapDataSetID[part] = mapDataSetID;
+	++_terrainVersion;
+	++_mapGeneration;
 }
 
 /**
@@ -347,6 +351,12 @@ int Tile::closeUfoDoor()
 		}
 	}
 
+	if (retval)
+	{
+		++_terrainVersion;
+		++_mapGeneration;
+	}
+
 	return retval;
 }
 
@@ -405,6 +415,16 @@ void Tile::addLight(int light, int layer)
 		_light[layer] = light;
 }
 
+/**
+ * Gets the light amount on the tile for a single layer.
+ * @param layer Light is separated in 3 layers: Ambient, Static and Dynamic.
+ * @return Light amount 0-15.
+ */
+int Tile::getLight(int layer) const
+{
+	return _light[layer];
+}
+
 /**
  * Gets the tile's shade amount 0-15. It returns the brightest of all light layers.
  * Shade level is the inverse of light level. So a maximum amount of light (15) returns shade level 0.
@@ -551,6 +571,7 @@ void Tile::ignite(int power)
 				_overlaps = 1;
 				_fire = getFuel() + 1;
 				_animationOffset = RNG::generate(0,3);
+				++_mapGeneration;
 			}
 		}
 	}
@@ -581,6 +602,12 @@ void Tile::animate()
 			{
 				newframe = 0;
 			}
+			if (_objects[i]->isUFODoor() && newframe == 7)
+			{
+				// fully open ufo doors can be walked through
+				++_terrainVersion;
+				++_mapGeneration;
+			}
 			_currentFrame[i] = newframe;
 		}
 	}
@@ -609,6 +636,10 @@ void Tile::setUnit(BattleUnit *unit, Tile *tileBelow)
 	{
 		unit->setTile(this, tileBelow);
 	}
+	if (_unit != unit)
+	{
+		++_mapGeneration;
+	}
 	_unit = unit;
 }
 
@@ -618,6 +649,10 @@ void Tile::setUnit(BattleUnit *unit, Tile *tileBelow)
  */
 void Tile::setFire(int fire)
 {
+	if ((_fire > 0) != (fire > 0))
+	{
+		++_mapGeneration;
+	}
 	_fire = fire;
 	_animationOffset = RNG::generate(0,3);
 }
@@ -78,6 +78,8 @@ protected:
 	int _TUMarker;
 	int _overlaps;
 	bool _danger;
+	int _terrainVersion;
+	static int _mapGeneration;
 public:
 	/// Creates a tile.
 	Tile(const Position& pos);
@@ -106,6 +108,28 @@ public:
 		return _objects[part];
 	}
 
+	/**
+	 * Gets the version of this tile's terrain. It changes every time a
+	 * tile part is replaced (destroyed, door opened, ...), so cached
+	 * data derived from the terrain can tell when it is out of date.
+	 * @return version number.
+	 */
+	int getTerrainVersion() const
+	{
+		return _terrainVersion;
+	}
+
+	/**
+	 * Gets the generation of the battlescape map. It changes every time
+	 * the terrain, the occupying unit or the fire of any tile changes,
+	 * so cached path costs can tell when they are out of date.
+	 * @return generation number.
+	 */
+	static int getMapGeneration()
+	{
+		return _mapGeneration;
+	}
+
 	/// Sets the pointer to the mapdata for a specific part of the tile
 	void setMapData(MapData *dat, int mapDataID, int mapDataSetID, int part);
 	/// Gets the IDs to the mapdata for a specific part of the tile
@@ -156,6 +180,8 @@ public:
 	void resetLight(int layer);
 	/// Add light to this tile.
 	void addLight(int light, int layer);
+	/// Get the light amount of a single layer.
+	int getLight(int layer) const;
 	/// Get the shade amount.
 	int getShade() const;
 	/// Destroy a tile part.
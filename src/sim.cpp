@@ -0,0 +1,819 @@
+/*
+ * Copyright 2010-2013 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include "version.h"
+#include "Engine/Exception.h"
+#include "Engine/Logger.h"
+#include "Engine/CrossPlatform.h"
+#include "Engine/Game.h"
+#include "Engine/Options.h"
+#include "Engine/Screen.h"
+#include "Engine/Zoom.h"
+#include "Engine/ThreadPool.h"
+#include "Engine/RNG.h"
+#include "Resource/XcomResourcePack.h"
+#include "Ruleset/Ruleset.h"
+#include "Ruleset/RuleCraft.h"
+#include "Ruleset/RuleCountry.h"
+#include "Ruleset/RuleRegion.h"
+#include "Ruleset/RuleItem.h"
+#include "Ruleset/RuleTerrain.h"
+#include "Savegame/SavedGame.h"
+#include "Savegame/SavedBattleGame.h"
+#include "Savegame/Base.h"
+#include "Savegame/Craft.h"
+#include "Savegame/Soldier.h"
+#include "Savegame/ItemContainer.h"
+#include "Savegame/Ufo.h"
+#include "Savegame/TerrorSite.h"
+#include "Battlescape/BattlescapeGenerator.h"
+#include "Battlescape/BattlescapeState.h"
+#include "Battlescape/BattlescapeGame.h"
+#include "Battlescape/Map.h"
+#include "Battlescape/Camera.h"
+
+/*
+ * openxcom-sim plays out battlescape missions with the AI on both sides
+ * and no window, to profile and regression test the AI and TileEngine.
+ * It needs the same data as the game, and takes the same options, plus:
+ *   -battles N      number of battles to play (default 10)
+ *   -seed N         RNG seed of the first battle (default 1)
+ *   -turns N        turn limit per battle (default 30)
+ *   -mission ID     ufo type or STR_TERROR_MISSION (default random)
+ *   -difficulty N   0-4 (default 0)
+ * Only ufo and terror missions are supported, missions that end by
+ * destroying an objective would need the debriefing.
+ * Instead of battles, it can time saving and loading a save:
+ *   -savebench FILE save in the user folder to load and save
+ *   -runs N         number of times to load and save it (default 10)
+ * or time the screen scalers, with and without the worker threads:
+ *   -scalebench     scale a frame to every filter and size -runs times
+ * or time drawing the battlescape with the camera all over a map:
+ *   -drawbench      draw a generated battle from every 10 tiles -runs times
+ * or check the country and region lookup grids against a linear scan:
+ *   -gridcheck      compare them on a 0.05 degree lattice and every area's edges
+ */
+
+using namespace OpenXcom;
+
+namespace
+{
+
+/// Ways a simulated battle can end.
+enum BattleOutcome { OUTCOME_VICTORY, OUTCOME_DEFEAT, OUTCOME_TURN_LIMIT, OUTCOME_STUCK };
+
+/// Settings shared by all the simulated battles.
+struct SimSettings
+{
+	int battles, seed, turns, difficulty, runs;
+	std::string mission, saveBenchmark;
+	bool scaleBenchmark, drawBenchmark, gridCheck;
+	SimSettings() : battles(10), seed(1), turns(30), difficulty(0), runs(10), scaleBenchmark(false), drawBenchmark(false), gridCheck(false) { }
+};
+
+/// How a simulated battle went.
+struct BattleResult
+{
+	std::string mission;
+	BattleOutcome outcome;
+	int turns, liveAliens, liveSoldiers;
+	Uint32 ticks;
+	// time spent and turns played by each faction
+	Uint32 sideTicks[3], maxTurnTicks;
+	int sideTurns[3];
+	BattleResult() : outcome(OUTCOME_STUCK), turns(0), liveAliens(0), liveSoldiers(0), ticks(0), maxTurnTicks(0)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			sideTicks[i] = 0;
+			sideTurns[i] = 0;
+		}
+	}
+};
+
+// the AI doesn't take this long to finish a turn unless it's going round in circles
+const int MAX_STEPS_PER_TURN = 500000;
+
+/**
+ * Parses the simulator's own command line arguments.
+ * The rest are left for the options.
+ * @param argc Number of arguments.
+ * @param argv Array of argument strings.
+ * @param settings Settings to fill in.
+ * @return False if help was asked for.
+ */
+bool loadSettings(int argc, char *argv[], SimSettings *settings)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "-help" || arg == "--help" || arg == "-?")
+		{
+			std::cout << "OpenXcom battle simulator v" << OPENXCOM_VERSION_SHORT << std::endl;
+			std::cout << "Usage: openxcom-sim [-battles N] [-seed N] [-turns N] [-mission ID] [-difficulty N] [OPTION]..." << std::endl;
+			std::cout << "       openxcom-sim -savebench FILE [-runs N] [OPTION]..." << std::endl;
+			std::cout << "       openxcom-sim -scalebench [-runs N] [OPTION]..." << std::endl;
+			std::cout << "       openxcom-sim -drawbench [-runs N] [-seed N] [-mission ID] [OPTION]..." << std::endl;
+			std::cout << "       openxcom-sim -gridcheck [OPTION]..." << std::endl;
+			return false;
+		}
+		if (arg == "-scalebench")
+		{
+			settings->scaleBenchmark = true;
+			continue;
+		}
+		if (arg == "-drawbench")
+		{
+			settings->drawBenchmark = true;
+			continue;
+		}
+		if (arg == "-gridcheck")
+		{
+			settings->gridCheck = true;
+			continue;
+		}
+		if (i + 1 >= argc)
+		{
+			break;
+		}
+		std::string value = argv[i + 1];
+		if (arg == "-battles")
+			settings->battles = atoi(value.c_str());
+		else if (arg == "-seed")
+			settings->seed = atoi(value.c_str());
+		else if (arg == "-turns")
+			settings->turns = atoi(value.c_str());
+		else if (arg == "-mission")
+			settings->mission = value;
+		else if (arg == "-difficulty")
+			settings->difficulty = atoi(value.c_str());
+		else if (arg == "-savebench")
+			settings->saveBenchmark = value;
+		else if (arg == "-runs")
+			settings->runs = atoi(value.c_str());
+		else
+			continue;
+		++i;
+	}
+	return true;
+}
+
+/**
+ * Creates a savegame with a base holding a craft full of
+ * soldiers and one of every item, same as the New Battle menu.
+ * @param game Pointer to the game.
+ * @return Pointer to the craft.
+ */
+Craft *newSave(Game *game)
+{
+	Ruleset *rule = game->getRuleset();
+	SavedGame *save = new SavedGame();
+	Base *base = new Base(rule);
+	base->load(rule->getStartingBase(), save, true, true);
+	save->getBases()->push_back(base);
+
+	for (std::vector<Soldier*>::iterator i = base->getSoldiers()->begin(); i != base->getSoldiers()->end(); ++i) delete (*i);
+	base->getSoldiers()->clear();
+	for (std::vector<Craft*>::iterator i = base->getCrafts()->begin(); i != base->getCrafts()->end(); ++i) delete (*i);
+	base->getCrafts()->clear();
+	base->getItems()->clear();
+
+	std::string craftType;
+	const std::vector<std::string> &crafts = rule->getCraftsList();
+	for (std::vector<std::string>::const_iterator i = crafts.begin(); i != crafts.end() && craftType.empty(); ++i)
+	{
+		if (rule->getCraft(*i)->getSoldiers() > 0)
+		{
+			craftType = *i;
+		}
+	}
+	Craft *craft = new Craft(rule->getCraft(craftType), base, 1);
+	base->getCrafts()->push_back(craft);
+
+	for (int i = 0; i < craft->getRules()->getSoldiers(); ++i)
+	{
+		Soldier *soldier = rule->genSoldier(save);
+		base->getSoldiers()->push_back(soldier);
+		soldier->setCraft(craft);
+	}
+
+	const std::vector<std::string> &items = rule->getItemsList();
+	for (std::vector<std::string>::const_iterator i = items.begin(); i != items.end(); ++i)
+	{
+		RuleItem *item = rule->getItem(*i);
+		if (item->getBattleType() != BT_CORPSE && item->isRecoverable()
+			&& item->getBattleType() != BT_NONE && !item->isFixed() && item->getBigSprite() > -1)
+		{
+			craft->getItems()->addItem(*i, 1);
+		}
+	}
+
+	const std::vector<std::string> &research = rule->getResearchList();
+	for (std::vector<std::string>::const_iterator i = research.begin(); i != research.end(); ++i)
+	{
+		save->addFinishedResearch(rule->getResearch(*i));
+	}
+
+	game->setSavedGame(save);
+	return craft;
+}
+
+/**
+ * Generates a new battle, picking whatever isn't
+ * set up with the RNG.
+ * @param game Pointer to the game.
+ * @param settings Simulator settings.
+ * @param result Gets the mission type.
+ * @return Pointer to the mission site, deleted by the caller.
+ */
+Target *newBattle(Game *game, const SimSettings &settings, BattleResult *result)
+{
+	Ruleset *rule = game->getRuleset();
+	Craft *craft = newSave(game);
+
+	std::vector<std::string> missions;
+	const std::vector<std::string> &deployments = rule->getDeploymentsList();
+	for (std::vector<std::string>::const_iterator i = deployments.begin(); i != deployments.end(); ++i)
+	{
+		if (*i == "STR_TERROR_MISSION" || rule->getUfo(*i) != 0)
+		{
+			missions.push_back(*i);
+		}
+	}
+	std::string mission = settings.mission;
+	if (mission.empty())
+	{
+		mission = missions[RNG::generate(0, missions.size()-1)];
+	}
+	result->mission = mission;
+
+	std::vector<int> textures;
+	const std::vector<std::string> &terrains = rule->getTerrainList();
+	for (std::vector<std::string>::const_iterator i = terrains.begin(); i != terrains.end(); ++i)
+	{
+		if (!rule->getTerrain(*i)->getTextures()->empty())
+		{
+			textures.push_back(rule->getTerrain(*i)->getTextures()->at(0));
+		}
+	}
+
+	SavedBattleGame *bgame = new SavedBattleGame();
+	game->getSavedGame()->setBattleGame(bgame);
+	bgame->setMissionType(mission);
+	game->getSavedGame()->setDifficulty((GameDifficulty)settings.difficulty);
+	BattlescapeGenerator bgen = BattlescapeGenerator(game);
+	bgen.setWorldTexture(textures[RNG::generate(0, textures.size()-1)]);
+
+	Target *site;
+	if (mission == "STR_TERROR_MISSION")
+	{
+		TerrorSite *t = new TerrorSite();
+		t->setId(1);
+		craft->setDestination(t);
+		bgen.setTerrorSite(t);
+		site = t;
+	}
+	else
+	{
+		RuleUfo *ufoRule = rule->getUfo(mission);
+		if (ufoRule == 0)
+		{
+			throw Exception(mission + " is not a ufo or terror mission");
+		}
+		Ufo *u = new Ufo(ufoRule);
+		u->setId(1);
+		craft->setDestination(u);
+		bgen.setUfo(u);
+		site = u;
+		if (RNG::generate(0, 1) == 1)
+			bgame->setMissionType("STR_UFO_GROUND_ASSAULT");
+		else
+			bgame->setMissionType("STR_UFO_CRASH_RECOVERY");
+	}
+	bgen.setCraft(craft);
+	craft->setSpeed(0);
+
+	const std::vector<std::string> &races = rule->getAlienRacesList();
+	bgen.setWorldShade(RNG::generate(0, 15));
+	bgen.setAlienRace(races[RNG::generate(0, races.size()-1)]);
+	bgen.setAlienItemlevel(RNG::generate(0, rule->getAlienItemLevels().size()-1));
+	bgen.run();
+	return site;
+}
+
+/**
+ * Plays out a battle with the AI on both sides, skipping all the
+ * popups, until one side is wiped out or the turn limit is hit.
+ * @param game Pointer to the game.
+ * @param settings Simulator settings.
+ * @param seed RNG seed for the battle.
+ * @return How the battle went.
+ */
+BattleResult playBattle(Game *game, const SimSettings &settings, int seed)
+{
+	BattleResult result;
+	RNG::setSeed(seed);
+	Uint32 start = SDL_GetTicks();
+	Target *site = newBattle(game, settings, &result);
+
+	SavedBattleGame *save = game->getSavedGame()->getSavedBattle();
+	BattlescapeState *battle = new BattlescapeState(game);
+	BattlescapeGame *battleGame = battle->getBattleGame();
+	save->setBattleState(battle);
+	battleGame->setPlayerAI(true);
+	game->setState(battle);
+	battle->init();
+
+	battleGame->tallyUnits(result.liveAliens, result.liveSoldiers, false);
+	int side = save->getSide();
+	int steps = 0;
+	Uint32 turnStart = SDL_GetTicks();
+	while (result.liveAliens > 0 && result.liveSoldiers > 0 && save->getTurn() <= settings.turns)
+	{
+		battleGame->think();
+		battle->animate();
+		battle->handleState();
+
+		// nobody's there to close the popups (next turn, casualties...)
+		if (!game->isState(battle))
+		{
+			while (!game->isState(battle))
+			{
+				game->popState();
+			}
+			game->cleanupStates();
+			battleGame->tallyUnits(result.liveAliens, result.liveSoldiers, false);
+		}
+
+		if (save->getSide() != side)
+		{
+			Uint32 now = SDL_GetTicks();
+			result.sideTicks[side] += now - turnStart;
+			result.sideTurns[side]++;
+			result.maxTurnTicks = std::max(result.maxTurnTicks, now - turnStart);
+			side = save->getSide();
+			turnStart = now;
+			steps = 0;
+		}
+		else if (++steps > MAX_STEPS_PER_TURN)
+		{
+			break;
+		}
+	}
+
+	result.turns = save->getTurn();
+	if (result.liveSoldiers == 0)
+		result.outcome = OUTCOME_DEFEAT;
+	else if (result.liveAliens == 0)
+		result.outcome = OUTCOME_VICTORY;
+	else if (steps > MAX_STEPS_PER_TURN)
+		result.outcome = OUTCOME_STUCK;
+	else
+		result.outcome = OUTCOME_TURN_LIMIT;
+
+	game->popState();
+	game->cleanupStates();
+	delete site;
+	game->setSavedGame(0);
+	result.ticks = SDL_GetTicks() - start;
+	return result;
+}
+
+/**
+ * Gets the average time per turn in milliseconds.
+ * @param ticks Total time.
+ * @param turns Number of turns.
+ * @return Average time.
+ */
+double average(Uint32 ticks, int turns)
+{
+	return turns > 0 ? (double)ticks / turns : 0.0;
+}
+
+/**
+ * Times saving and loading a save in each format.
+ * @param game Pointer to the game.
+ * @param settings Simulator settings.
+ */
+void benchmarkSave(Game *game, const SimSettings &settings)
+{
+	const std::string temp = "_savebench_.sav";
+	SavedGame *save = new SavedGame();
+	save->load(settings.saveBenchmark, game->getRuleset());
+	game->setSavedGame(save);
+
+	const SaveFormat formats[] = {SAVE_FORMAT_YAML, SAVE_FORMAT_BINARY};
+	const char *names[] = {"YAML", "binary"};
+	for (int i = 0; i < 2; ++i)
+	{
+		Uint32 start = SDL_GetTicks();
+		for (int j = 0; j < settings.runs; ++j)
+		{
+			save->save(temp, formats[i]);
+		}
+		Uint32 saveTicks = SDL_GetTicks() - start;
+
+		start = SDL_GetTicks();
+		for (int j = 0; j < settings.runs; ++j)
+		{
+			SavedGame *copy = new SavedGame();
+			copy->load(temp, game->getRuleset());
+			delete copy;
+		}
+		Uint32 loadTicks = SDL_GetTicks() - start;
+
+		std::ifstream file((Options::getUserFolder() + temp).c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+		std::cout << names[i] << ": " << file.tellg() / 1024 << " KB, save " << average(saveTicks, settings.runs)
+			<< " ms, load " << average(loadTicks, settings.runs) << " ms" << std::endl;
+	}
+	CrossPlatform::deleteFile(Options::getUserFolder() + temp);
+	game->setSavedGame(0);
+}
+
+/**
+ * Times scaling a frame up to the display with each of the
+ * screen filters, on one thread and on the thread pool.
+ * @param game Pointer to the game.
+ * @param settings Simulator settings.
+ */
+void benchmarkScale(Game *game, const SimSettings &settings)
+{
+	struct Scaler
+	{
+		const char *name;
+		int bpp;
+		bool hqx, scale;
+		int width, height;
+	};
+	const Scaler scalers[] = {
+		{"nearest 1.5x", 8, false, false, 480, 300},
+		{"nearest 2x", 8, false, false, 640, 400},
+		{"nearest 3x", 8, false, false, 960, 600},
+		{"nearest 4x", 8, false, false, 1280, 800},
+		{"scale2x", 8, false, true, 640, 400},
+		{"scale3x", 8, false, true, 960, 600},
+		{"scale4x", 8, false, true, 1280, 800},
+		{"hq2x", 32, true, false, 640, 400},
+		{"hq3x", 32, true, false, 960, 600},
+		{"hq4x", 32, true, false, 1280, 800},
+	};
+	const bool hqx = Options::useHQXFilter, scale = Options::useScaleFilter;
+	RNG::setSeed(settings.seed);
+
+	for (size_t i = 0; i < sizeof(scalers) / sizeof(scalers[0]); ++i)
+	{
+		const Scaler &scaler = scalers[i];
+		SDL_Surface *src = SDL_CreateRGBSurface(SDL_SWSURFACE, Screen::ORIGINAL_WIDTH, Screen::ORIGINAL_HEIGHT, scaler.bpp, 0, 0, 0, 0);
+		SDL_Surface *dst = SDL_CreateRGBSurface(SDL_SWSURFACE, scaler.width, scaler.height, scaler.bpp, 0, 0, 0, 0);
+		// blocks of color, so the filters have some edges to work on
+		for (int y = 0; y < src->h; ++y)
+		{
+			for (int x = 0; x < src->pitch; ++x)
+			{
+				((Uint8*)src->pixels)[y * src->pitch + x] = (RNG::generate(0, 7) == 0) ? RNG::generate(0, 255) : (x / 16 + y / 8) * 16;
+			}
+		}
+		Options::useHQXFilter = scaler.hqx;
+		Options::useScaleFilter = scaler.scale;
+
+		Uint32 ticks[2];
+		ThreadPool *pools[] = {0, game->getThreadPool()};
+		for (int j = 0; j < 2; ++j)
+		{
+			Uint32 start = SDL_GetTicks();
+			for (int k = 0; k < settings.runs; ++k)
+			{
+				Zoom::_zoomSurfaceY(src, dst, 0, 0, pools[j]);
+			}
+			ticks[j] = SDL_GetTicks() - start;
+		}
+		std::cout << scaler.name << " to " << scaler.width << "x" << scaler.height << ": "
+			<< average(ticks[0], settings.runs) << " ms on 1 thread, "
+			<< average(ticks[1], settings.runs) << " ms on " << game->getThreadPool()->getThreadCount() << " threads" << std::endl;
+
+		SDL_FreeSurface(dst);
+		SDL_FreeSurface(src);
+	}
+	Options::useHQXFilter = hqx;
+	Options::useScaleFilter = scale;
+}
+
+/**
+ * Times drawing the battlescape map, with the camera
+ * moved across a generated battle on every level.
+ * @param game Pointer to the game.
+ * @param settings Simulator settings.
+ */
+void benchmarkDraw(Game *game, const SimSettings &settings)
+{
+	BattleResult result;
+	RNG::setSeed(settings.seed);
+	Target *site = newBattle(game, settings, &result);
+
+	SavedBattleGame *save = game->getSavedGame()->getSavedBattle();
+	BattlescapeState *battle = new BattlescapeState(game);
+	save->setBattleState(battle);
+	game->setState(battle);
+	battle->init();
+
+	Map *map = battle->getMap();
+	Camera *camera = map->getCamera();
+	int frames = 0;
+	Uint32 start = SDL_GetTicks();
+	for (int i = 0; i < settings.runs; ++i)
+	{
+		for (int z = 0; z < save->getMapSizeZ(); ++z)
+		{
+			for (int y = 0; y < save->getMapSizeY(); y += 10)
+			{
+				for (int x = 0; x < save->getMapSizeX(); x += 10)
+				{
+					camera->centerOnPosition(Position(x, y, z), false);
+					map->invalidate();
+					map->draw();
+					frames++;
+				}
+			}
+		}
+	}
+	Uint32 ticks = SDL_GetTicks() - start;
+	std::cout << result.mission << " on a " << save->getMapSizeX() << "x" << save->getMapSizeY() << "x" << save->getMapSizeZ()
+		<< " map, " << map->getWidth() << "x" << map->getHeight() << " view: "
+		<< average(ticks, frames) << " ms per frame over " << frames << " frames" << std::endl;
+
+	game->popState();
+	game->cleanupStates();
+	delete site;
+	game->setSavedGame(0);
+}
+
+/**
+ * Finds the country containing a point by checking
+ * every country in ruleset order, like the game used to.
+ * @param rule Pointer to the ruleset.
+ * @param lon Longitude in radians.
+ * @param lat Latitude in radians.
+ * @return Pointer to the country rules, or 0.
+ */
+RuleCountry *scanCountries(Ruleset *rule, double lon, double lat)
+{
+	const std::vector<std::string> &countries = rule->getCountriesList();
+	for (std::vector<std::string>::const_iterator i = countries.begin(); i != countries.end(); ++i)
+	{
+		if (rule->getCountry(*i)->insideCountry(lon, lat))
+		{
+			return rule->getCountry(*i);
+		}
+	}
+	return 0;
+}
+
+/**
+ * Finds the region containing a point by checking
+ * every region in ruleset order, like the game used to.
+ * @param rule Pointer to the ruleset.
+ * @param lon Longitude in radians.
+ * @param lat Latitude in radians.
+ * @return Pointer to the region rules, or 0.
+ */
+RuleRegion *scanRegions(Ruleset *rule, double lon, double lat)
+{
+	const std::vector<std::string> &regions = rule->getRegionsList();
+	for (std::vector<std::string>::const_iterator i = regions.begin(); i != regions.end(); ++i)
+	{
+		if (rule->getRegion(*i)->insideRegion(lon, lat))
+		{
+			return rule->getRegion(*i);
+		}
+	}
+	return 0;
+}
+
+/**
+ * Compares the lookup grids with a linear scan at one point.
+ * @param rule Pointer to the ruleset.
+ * @param lon Longitude in radians.
+ * @param lat Latitude in radians.
+ * @return Number of lookups that came out different (0-2).
+ */
+int checkGridPoint(Ruleset *rule, double lon, double lat)
+{
+	int mismatches = 0;
+	if (rule->locateCountry(lon, lat) != scanCountries(rule, lon, lat))
+	{
+		std::cout << "Country mismatch at lon " << lon << ", lat " << lat << std::endl;
+		mismatches++;
+	}
+	if (rule->locateRegion(lon, lat) != scanRegions(rule, lon, lat))
+	{
+		std::cout << "Region mismatch at lon " << lon << ", lat " << lat << std::endl;
+		mismatches++;
+	}
+	return mismatches;
+}
+
+/**
+ * Checks the lookup grids against the edges of an area's rectangles,
+ * where a point is most likely to land in the wrong grid cell.
+ * @param rule Pointer to the ruleset.
+ * @param area Country or region rules.
+ * @param points Incremented by the number of points checked.
+ * @return Number of lookups that came out different.
+ */
+template <typename T>
+int checkGridEdges(Ruleset *rule, T *area, int *points)
+{
+	int mismatches = 0;
+	for (size_t i = 0; i < area->getLonMin().size(); ++i)
+	{
+		const double lons[] = {area->getLonMin()[i], area->getLonMax()[i]};
+		const double lats[] = {area->getLatMin()[i], area->getLatMax()[i]};
+		for (int j = 0; j < 2; ++j)
+		{
+			for (int k = 0; k < 2; ++k)
+			{
+				mismatches += checkGridPoint(rule, lons[j], lats[k]);
+				(*points)++;
+			}
+		}
+	}
+	return mismatches;
+}
+
+/**
+ * Checks that the country and region lookup grids give the
+ * same answers as checking every area in ruleset order.
+ * @param game Pointer to the game.
+ * @return True if no lookup came out different.
+ */
+bool checkGrids(Game *game)
+{
+	Ruleset *rule = game->getRuleset();
+	const int STEPS_PER_DEGREE = 20;
+	int points = 0, mismatches = 0;
+	Uint32 start = SDL_GetTicks();
+	for (int y = 0; y <= 180 * STEPS_PER_DEGREE; ++y)
+	{
+		double lat = (y / (double)STEPS_PER_DEGREE - 90.0) * M_PI / 180.0;
+		for (int x = 0; x < 360 * STEPS_PER_DEGREE; ++x)
+		{
+			double lon = x / (double)STEPS_PER_DEGREE * M_PI / 180.0;
+			mismatches += checkGridPoint(rule, lon, lat);
+			points++;
+		}
+	}
+	const std::vector<std::string> &countries = rule->getCountriesList();
+	for (std::vector<std::string>::const_iterator i = countries.begin(); i != countries.end(); ++i)
+	{
+		mismatches += checkGridEdges(rule, rule->getCountry(*i), &points);
+	}
+	const std::vector<std::string> &regions = rule->getRegionsList();
+	for (std::vector<std::string>::const_iterator i = regions.begin(); i != regions.end(); ++i)
+	{
+		mismatches += checkGridEdges(rule, rule->getRegion(*i), &points);
+	}
+	std::cout << points << " points checked in " << SDL_GetTicks() - start << " ms, " << mismatches << " mismatches" << std::endl;
+	return mismatches == 0;
+}
+
+/**
+ * Gets a readable name for a battle outcome.
+ * @param outcome Battle outcome.
+ * @return Outcome name.
+ */
+std::string outcomeName(BattleOutcome outcome)
+{
+	switch (outcome)
+	{
+	case OUTCOME_VICTORY:
+		return "victory";
+	case OUTCOME_DEFEAT:
+		return "defeat";
+	case OUTCOME_TURN_LIMIT:
+		return "turn limit";
+	default:
+		return "stuck";
+	}
+}
+
+}
+
+// Plays out a bunch of battles and reports how long they took.
+int main(int argc, char *argv[])
+{
+	SimSettings settings;
+	if (!loadSettings(argc, argv, &settings))
+		return EXIT_SUCCESS;
+	try
+	{
+		Logger::reportingLevel() = LOG_INFO;
+		if (!Options::init(argc, argv))
+			return EXIT_SUCCESS;
+		// nothing is shown or heard, so keep it all as small and quiet as possible
+		SDL_putenv((char*)"SDL_VIDEODRIVER=dummy");
+		SDL_putenv((char*)"SDL_AUDIODRIVER=dummy");
+		Options::displayWidth = Screen::ORIGINAL_WIDTH;
+		Options::displayHeight = Screen::ORIGINAL_HEIGHT;
+		Options::baseXResolution = Screen::ORIGINAL_WIDTH;
+		Options::baseYResolution = Screen::ORIGINAL_HEIGHT;
+		Options::fullscreen = false;
+		Options::useOpenGL = false;
+		Game *game = new Game("OpenXcom Simulator");
+		Options::mute = true;
+
+		if (settings.scaleBenchmark)
+		{
+			benchmarkScale(game, settings);
+			delete game;
+			return EXIT_SUCCESS;
+		}
+
+		game->loadRuleset();
+
+		if (settings.gridCheck)
+		{
+			bool ok = checkGrids(game);
+			delete game;
+			return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+
+		game->setResourcePack(new XcomResourcePack(game->getRuleset()->getExtraSprites(), game->getRuleset()->getExtraSounds()));
+		game->defaultLanguage();
+
+		if (!settings.saveBenchmark.empty())
+		{
+			benchmarkSave(game, settings);
+			delete game;
+			return EXIT_SUCCESS;
+		}
+
+		if (settings.drawBenchmark)
+		{
+			benchmarkDraw(game, settings);
+			delete game;
+			return EXIT_SUCCESS;
+		}
+
+		BattleResult total;
+		int outcomes[4] = {0, 0, 0, 0};
+		for (int i = 0; i < settings.battles; ++i)
+		{
+			BattleResult result = playBattle(game, settings, settings.seed + i);
+			std::cout << "Battle " << i + 1 << " (seed " << settings.seed + i << ", " << result.mission << "): "
+				<< outcomeName(result.outcome) << " on turn " << result.turns << ", "
+				<< result.liveSoldiers << " soldiers and " << result.liveAliens << " aliens left, "
+				<< result.ticks << " ms" << std::endl;
+			outcomes[result.outcome]++;
+			total.ticks += result.ticks;
+			total.turns += result.turns;
+			total.maxTurnTicks = std::max(total.maxTurnTicks, result.maxTurnTicks);
+			for (int j = 0; j < 3; ++j)
+			{
+				total.sideTicks[j] += result.sideTicks[j];
+				total.sideTurns[j] += result.sideTurns[j];
+			}
+		}
+
+		std::cout << std::endl << settings.battles << " battles in " << total.ticks << " ms, "
+			<< (total.ticks > 0 ? settings.battles * 1000.0 / total.ticks : 0.0) << " battles per second" << std::endl;
+		std::cout << "Average turn: xcom " << average(total.sideTicks[FACTION_PLAYER], total.sideTurns[FACTION_PLAYER])
+			<< " ms, aliens " << average(total.sideTicks[FACTION_HOSTILE], total.sideTurns[FACTION_HOSTILE])
+			<< " ms, civilians " << average(total.sideTicks[FACTION_NEUTRAL], total.sideTurns[FACTION_NEUTRAL])
+			<< " ms, slowest " << total.maxTurnTicks << " ms" << std::endl;
+		std::cout << "Outcomes: " << outcomes[OUTCOME_VICTORY] << " victories, " << outcomes[OUTCOME_DEFEAT] << " defeats, "
+			<< outcomes[OUTCOME_TURN_LIMIT] << " hit the turn limit, " << outcomes[OUTCOME_STUCK] << " stuck" << std::endl;
+
+		delete game;
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}